@@ -0,0 +1,724 @@
+// Synthetic layout benchmarks for clay.
+// Each scenario is laid out repeatedly, and the mean time per frame is printed.
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS
+#endif
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+// The layout from the video demo, which is used as a recorded real world layout
+#include "../../examples/shared-layouts/clay-video-demo.c"
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/mman.h>
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+double Bench_NowSeconds(void) {
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+#include <time.h>
+double Bench_NowSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+const Clay_Color BENCH_COLOR_BACKGROUND = { 30, 30, 40, 255 };
+const Clay_Color BENCH_COLOR_PANEL = { 90, 90, 120, 255 };
+
+typedef struct {
+    const char *name;
+    int32_t size;
+    void (*declareLayout)(int32_t size);
+} Bench_Scenario;
+
+void Bench_HandleClayErrors(Clay_ErrorData errorData) {
+    fprintf(stderr, "%.*s\n", errorData.errorText.length, errorData.errorText.chars);
+}
+
+// A monospace approximation is enough to exercise clay's text code paths without depending on a font library
+Clay_Dimensions Bench_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    (void)userData;
+    return (Clay_Dimensions) { (float)text.length * (float)config->fontSize * 0.6f, (float)config->fontSize };
+}
+
+// Floating roots with scattered z-indexes, e.g. tooltips, popovers and context menus
+void Bench_FloatingRoots(int32_t size) {
+    CLAY(CLAY_ID("FloatingRootsContainer"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) } }, .backgroundColor = BENCH_COLOR_BACKGROUND }) {
+        for (int32_t i = 0; i < size; ++i) {
+            CLAY(CLAY_IDI("FloatingRoot", i), {
+                .layout = { .sizing = { CLAY_SIZING_FIXED(40), CLAY_SIZING_FIXED(20) } },
+                .backgroundColor = BENCH_COLOR_PANEL,
+                .floating = {
+                    .attachTo = CLAY_ATTACH_TO_PARENT,
+                    .offset = { (float)((i * 37) % 1200), (float)((i * 53) % 700) },
+                    .zIndex = (int16_t)((i * 7919) % 200 - 100)
+                }
+            }) {}
+        }
+    }
+}
+
+// A scrolling table with a text label in every cell
+void Bench_Table(int32_t size) {
+    Clay_TextElementConfig *textConfig = CLAY_TEXT_CONFIG({ .fontSize = 14, .textColor = { 255, 255, 255, 255 } });
+    CLAY(CLAY_ID("Table"), {
+        .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 1 },
+        .backgroundColor = BENCH_COLOR_BACKGROUND,
+        .clip = { .vertical = true, .childOffset = Clay_GetScrollOffset() }
+    }) {
+        for (int32_t row = 0; row < size; ++row) {
+            CLAY(CLAY_IDI("TableRow", row), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(20) }, .childGap = 1 } }) {
+                for (int32_t column = 0; column < 8; ++column) {
+                    CLAY_AUTO_ID({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .padding = { 4, 4, 2, 2 } }, .backgroundColor = BENCH_COLOR_PANEL }) {
+                        CLAY_TEXT(CLAY_STRING("Cell"), textConfig);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Rows of wrapping text that is too wide for the window, so every row compresses its children over many passes
+void Bench_CompressedRows(int32_t size) {
+    Clay_TextElementConfig *textConfig = CLAY_TEXT_CONFIG({ .fontSize = 14, .textColor = { 255, 255, 255, 255 } });
+    const char *words = "a bb ccc dddd eeeee ffffff ggggggg hhhhhhhh iiiiiiiii jjjjjjjjjj";
+    CLAY(CLAY_ID("CompressedRowsContainer"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM }, .backgroundColor = BENCH_COLOR_BACKGROUND }) {
+        for (int32_t row = 0; row < size; ++row) {
+            CLAY(CLAY_IDI("CompressedRow", row), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .childGap = 2 } }) {
+                for (int32_t column = 0; column < 128; ++column) {
+                    // Prefixes of the word list, so that there are many distinct widths to compress
+                    Clay_String text = { .isStaticallyAllocated = true, .length = 1 + (column * 37 + row) % 32, .chars = words };
+                    CLAY_TEXT(text, textConfig);
+                }
+            }
+        }
+    }
+}
+
+// Spreadsheet style rows with hundreds of grow columns of different content widths, so every row grows its columns over many passes
+void Bench_WideGrowRows(int32_t size) {
+    CLAY(CLAY_ID("WideGrowRowsContainer"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM }, .clip = { .horizontal = true, .vertical = true, .childOffset = Clay_GetScrollOffset() } }) {
+        for (int32_t row = 0; row < size; ++row) {
+            CLAY(CLAY_IDI("WideGrowRow", row), { .layout = { .sizing = { CLAY_SIZING_FIXED(400000), CLAY_SIZING_FIXED(20) } } }) {
+                for (int32_t column = 0; column < 400; ++column) {
+                    CLAY(CLAY_IDI("WideGrowColumn", row * 400 + column), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) } }, .backgroundColor = BENCH_COLOR_PANEL }) {
+                        CLAY(CLAY_IDI("WideGrowContent", row * 400 + column), { .layout = { .sizing = { CLAY_SIZING_FIXED((float)((column * 37 + row) % 997)), CLAY_SIZING_FIXED(10) } } }) {}
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Bench_NestedElement(int32_t depth, int32_t size, Clay_TextElementConfig *textConfig) {
+    CLAY(CLAY_IDI("NestedElement", depth), {
+        .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .padding = CLAY_PADDING_ALL(1), .layoutDirection = depth % 2 == 0 ? CLAY_LEFT_TO_RIGHT : CLAY_TOP_TO_BOTTOM },
+        .backgroundColor = depth % 4 == 0 ? BENCH_COLOR_PANEL : (Clay_Color) { 0 }
+    }) {
+        if (depth % 8 == 0) {
+            CLAY_TEXT(CLAY_STRING("Nested"), textConfig);
+        }
+        if (depth + 1 < size) {
+            Bench_NestedElement(depth + 1, size, textConfig);
+        }
+    }
+}
+
+// A single chain of nested containers, e.g. deeply composed widgets, so every pass walks a tree as deep as the element count
+void Bench_DeepNesting(int32_t size) {
+    Bench_NestedElement(0, size, CLAY_TEXT_CONFIG({ .fontSize = 14, .textColor = { 255, 255, 255, 255 } }));
+}
+
+// A grid of independently scrolling panes, each with a few rows of text
+void Bench_ScrollContainers(int32_t size) {
+    Clay_TextElementConfig *textConfig = CLAY_TEXT_CONFIG({ .fontSize = 14, .textColor = { 255, 255, 255, 255 } });
+    CLAY(CLAY_ID("ScrollContainersGrid"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 2 } }) {
+        for (int32_t row = 0; row * 12 < size; ++row) {
+            CLAY(CLAY_IDI("ScrollContainersRow", row), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .childGap = 2 } }) {
+                for (int32_t i = row * 12; i < size && i < (row + 1) * 12; ++i) {
+                    CLAY(CLAY_IDI("ScrollContainer", i), {
+                        .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .padding = CLAY_PADDING_ALL(2) },
+                        .backgroundColor = BENCH_COLOR_PANEL,
+                        .clip = { .vertical = true, .childOffset = Clay_GetScrollOffset() }
+                    }) {
+                        for (int32_t line = 0; line < 16; ++line) {
+                            CLAY_TEXT(CLAY_STRING("Scrolling line"), textConfig);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Creates and activates a context in a newly allocated arena, which the caller frees with Bench_DestroyContext
+Clay_Arena Bench_CreateContext(int32_t maxElementCount) {
+    Clay_SetCurrentContext(NULL); // So that the max element count applies to the new context rather than the current one
+    Clay_SetMaxElementCount(maxElementCount);
+    Clay_SetArrayCapacities((Clay_ArrayCapacities) { .diffedRenderCommands = maxElementCount }); // So that render command diffing can be benchmarked
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 1280, 720 }, (Clay_ErrorHandler) { Bench_HandleClayErrors, NULL });
+    Clay_SetMeasureTextFunction(Bench_MeasureText, NULL);
+    return arena;
+}
+
+void Bench_DestroyContext(Clay_Arena arena, Clay_Context *previousContext) {
+    free(arena.memory);
+    Clay_SetCurrentContext(previousContext);
+}
+
+// A flat grid of elements with string IDs, used for element lookups
+void Bench_IdentifiedElements(int32_t size) {
+    CLAY(CLAY_ID("IdentifiedElementsContainer"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) } } }) {
+        for (int32_t i = 0; i < size; ++i) {
+            CLAY(CLAY_IDI("IdentifiedElement", i), { .layout = { .sizing = { CLAY_SIZING_FIXED(4), CLAY_SIZING_FIXED(4) } } }) {}
+        }
+    }
+}
+
+// Times Clay_GetElementData for every element of a laid out Bench_IdentifiedElements, in a scattered order.
+// Runs in a context sized for the scenario so that the hash map is as full as it would be in a real application.
+void Bench_ElementLookups(int32_t size) {
+    Clay_Context *previousContext = Clay_GetCurrentContext();
+    Clay_Arena arena = Bench_CreateContext(size + 64);
+    Clay_BeginLayout();
+    Bench_IdentifiedElements(size);
+    Clay_EndLayout();
+    Clay_ElementId *ids = (Clay_ElementId *)malloc(sizeof(Clay_ElementId) * size);
+    for (int32_t i = 0; i < size; ++i) {
+        ids[i] = Clay_GetElementIdWithIndex(CLAY_STRING("IdentifiedElement"), (uint32_t)(((int64_t)i * 7919) % size));
+    }
+    int64_t lookupCount = 0;
+    int64_t foundCount = 0;
+    double start = Bench_NowSeconds();
+    double elapsed = 0;
+    while (lookupCount < size * 10 || elapsed < 0.25) {
+        for (int32_t i = 0; i < size; ++i) {
+            foundCount += Clay_GetElementData(ids[i]).found;
+        }
+        lookupCount += size;
+        elapsed = Bench_NowSeconds() - start;
+    }
+    printf("%-24s %10d %14.2f %10.2f\n", "element lookups", size, elapsed * 1e9 / (double)lookupCount, (double)foundCount / (double)lookupCount);
+    free(ids);
+    Bench_DestroyContext(arena, previousContext);
+}
+
+// Times Clay_SetPointerState at scattered positions over a laid out Bench_Table
+void Bench_PointerHitTests(int32_t size) {
+    Clay_BeginLayout();
+    Bench_Table(size);
+    Clay_EndLayout();
+    int64_t hitTestCount = 0;
+    int64_t hoveredCount = 0;
+    double start = Bench_NowSeconds();
+    double elapsed = 0;
+    while (hitTestCount < 100 || elapsed < 0.25) {
+        for (int32_t i = 0; i < 100; ++i) {
+            Clay_SetPointerState((Clay_Vector2) { (float)((hitTestCount * 37) % 1280), (float)((hitTestCount * 53) % 720) }, false);
+            hoveredCount += Clay_GetPointerOverIds().length;
+            hitTestCount++;
+        }
+        elapsed = Bench_NowSeconds() - start;
+    }
+    printf("%-24s %10d %14.2f %10.2f\n", "pointer hit tests", size, elapsed * 1e6 / (double)hitTestCount, (double)hoveredCount / (double)hitTestCount);
+}
+
+// Times frames of Bench_Table with render command diffing enabled. If resize is true, the layout width alternates every frame so that
+// every command is modified, otherwise every frame is unchanged.
+void Bench_RenderCommandDiffs(int32_t size, bool resize) {
+    Clay_SetRenderCommandDiffingEnabled(true);
+    // The first frame after enabling diffing reports every command as inserted
+    Clay_BeginLayout();
+    Bench_Table(size);
+    Clay_EndLayout();
+    int32_t frameCount = 0;
+    int64_t changedCount = 0;
+    double start = Bench_NowSeconds();
+    double elapsed = 0;
+    while (frameCount < 10 || elapsed < 0.25) {
+        Clay_SetLayoutDimensions((Clay_Dimensions) { resize && frameCount % 2 ? 1279.f : 1280.f, 720 });
+        Clay_BeginLayout();
+        Bench_Table(size);
+        Clay_EndLayout();
+        Clay_RenderCommandDiff diff = Clay_GetRenderCommandDiff();
+        changedCount += diff.inserted.length + diff.removed.length + diff.modified.length;
+        frameCount++;
+        elapsed = Bench_NowSeconds() - start;
+    }
+    printf("%-24s %10d %14.2f %10.2f\n", resize ? "diffed resized table" : "diffed table rows", size, elapsed * 1e6 / frameCount, (double)changedCount / frameCount);
+    Clay_SetRenderCommandDiffingEnabled(false);
+    Clay_SetLayoutDimensions((Clay_Dimensions) { 1280, 720 });
+}
+
+char Bench_paragraphText[1 << 16];
+
+// Paragraphs of distinct wrapping text, sliced from a generated block of words
+void Bench_Paragraphs(int32_t size) {
+    if (!Bench_paragraphText[0]) {
+        int32_t length = 0;
+        for (int32_t word = 0; length < (int32_t)sizeof(Bench_paragraphText) - 16; ++word) {
+            length += snprintf(Bench_paragraphText + length, 16, "w%d ", (word * 7919) % 100000);
+        }
+    }
+    Clay_TextElementConfig *textConfig = CLAY_TEXT_CONFIG({ .fontSize = 14, .textColor = { 255, 255, 255, 255 } });
+    CLAY(CLAY_ID("Paragraphs"), { .layout = { .sizing = { CLAY_SIZING_FIXED(600), CLAY_SIZING_FIT(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM } }) {
+        for (int32_t i = 0; i < size; ++i) {
+            Clay_String text = { .isStaticallyAllocated = true, .length = 60 + (i * 31) % 200, .chars = Bench_paragraphText + (i * 97) % (sizeof(Bench_paragraphText) / 2) };
+            CLAY_TEXT(text, textConfig);
+        }
+    }
+}
+
+// Stands in for the fixed cost of calling into another language, e.g. from WASM into JavaScript
+void Bench_CrossBoundary(void) {
+    volatile int32_t spin = 0;
+    for (int32_t i = 0; i < 200; ++i) {
+        spin += i;
+    }
+}
+
+Clay_Dimensions Bench_MeasureTextAcrossBoundary(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    Bench_CrossBoundary();
+    return Bench_MeasureText(text, config, userData);
+}
+
+void Bench_MeasureTextBatchAcrossBoundary(const Clay_TextMeasurementRequest *requests, Clay_Dimensions *dimensions, int32_t requestCount, void *userData) {
+    Bench_CrossBoundary();
+    for (int32_t i = 0; i < requestCount; ++i) {
+        dimensions[i] = Bench_MeasureText(requests[i].text, requests[i].config, userData);
+    }
+}
+
+typedef enum {
+    BENCH_MEASURE_TEXT_LOCAL,
+    BENCH_MEASURE_TEXT_ACROSS_BOUNDARY,
+    BENCH_MEASURE_TEXT_BATCHED_ACROSS_BOUNDARY,
+} Bench_MeasureTextMode;
+
+// Lays out Bench_Paragraphs once in a newly created context, and returns the time taken. The context has to measure all of its text,
+// unless it's attached to a shared cache that already contains it.
+double Bench_FirstLayout(int32_t size, Clay_SharedMeasureTextCache *sharedCache, Bench_MeasureTextMode measureTextMode) {
+    Clay_Context *previousContext = Clay_GetCurrentContext();
+    // The max element count also sizes the text measurement cache, at two words per element
+    Clay_Arena arena = Bench_CreateContext(size * 32);
+    Clay_SetSharedMeasureTextCache(sharedCache);
+    if (measureTextMode == BENCH_MEASURE_TEXT_ACROSS_BOUNDARY) {
+        Clay_SetMeasureTextFunction(Bench_MeasureTextAcrossBoundary, NULL);
+    } else if (measureTextMode == BENCH_MEASURE_TEXT_BATCHED_ACROSS_BOUNDARY) {
+        Clay_SetMeasureTextFunction(Bench_MeasureTextAcrossBoundary, NULL);
+        Clay_SetMeasureTextBatchFunction(Bench_MeasureTextBatchAcrossBoundary, NULL);
+    }
+    double start = Bench_NowSeconds();
+    Clay_BeginLayout();
+    Bench_Paragraphs(size);
+    Clay_EndLayout();
+    double elapsed = Bench_NowSeconds() - start;
+    Bench_DestroyContext(arena, previousContext);
+    return elapsed;
+}
+
+// Times first layouts of newly created contexts, optionally sharing a text measurement cache that an earlier context has already filled
+void Bench_FirstLayouts(int32_t size, bool shareCache) {
+    Clay_SharedMeasureTextCache *sharedCache = NULL;
+    uint32_t sharedCacheMemorySize = Clay_MinSharedMeasureTextCacheMemorySize(size * 64);
+    void *sharedCacheMemory = malloc(sharedCacheMemorySize);
+    if (shareCache) {
+        sharedCache = Clay_InitializeSharedMeasureTextCache(Clay_CreateArenaWithCapacityAndMemory(sharedCacheMemorySize, sharedCacheMemory), size * 64);
+        Bench_FirstLayout(size, sharedCache, BENCH_MEASURE_TEXT_LOCAL);
+    }
+    int32_t layoutCount = 0;
+    double elapsed = 0;
+    while (layoutCount < 10 || elapsed < 0.25) {
+        elapsed += Bench_FirstLayout(size, sharedCache, BENCH_MEASURE_TEXT_LOCAL);
+        layoutCount++;
+    }
+    printf("%-24s %10d %14.2f\n", shareCache ? "shared cache layouts" : "first layouts", size, elapsed * 1e6 / (double)layoutCount);
+    free(sharedCacheMemory);
+}
+
+// Times first layouts of newly created contexts whose text measurement function is expensive to call, with and without batching
+void Bench_BoundaryFirstLayouts(int32_t size, bool batchMeasureText) {
+    int32_t layoutCount = 0;
+    double elapsed = 0;
+    while (layoutCount < 10 || elapsed < 0.25) {
+        elapsed += Bench_FirstLayout(size, NULL, batchMeasureText ? BENCH_MEASURE_TEXT_BATCHED_ACROSS_BOUNDARY : BENCH_MEASURE_TEXT_ACROSS_BOUNDARY);
+        layoutCount++;
+    }
+    printf("%-24s %10d %14.2f\n", batchMeasureText ? "batched boundary layouts" : "boundary layouts", size, elapsed * 1e6 / (double)layoutCount);
+}
+
+#ifndef _WIN32
+#define BENCH_THREAD_COUNT 4
+
+// A minimal job system for Clay_SetLayoutJobFunction. Worker threads and the calling thread take job indexes until none are left.
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t jobsAvailable;
+    pthread_cond_t jobsCompleted;
+    pthread_t threads[BENCH_THREAD_COUNT - 1];
+    void (*job)(int32_t jobIndex, void *jobData);
+    void *jobData;
+    int32_t jobCount;
+    int32_t nextJobIndex;
+    int32_t completedJobCount;
+    int32_t generation;
+} Bench_ThreadPool;
+
+Bench_ThreadPool Bench_threadPool;
+
+// Runs jobs from the current batch until none are left to start, with the mutex held on entry and exit
+void Bench_RunAvailableJobs(Bench_ThreadPool *pool) {
+    while (pool->nextJobIndex < pool->jobCount) {
+        int32_t jobIndex = pool->nextJobIndex++;
+        pthread_mutex_unlock(&pool->mutex);
+        pool->job(jobIndex, pool->jobData);
+        pthread_mutex_lock(&pool->mutex);
+        if (++pool->completedJobCount == pool->jobCount) {
+            pthread_cond_signal(&pool->jobsCompleted);
+        }
+    }
+}
+
+void *Bench_WorkerThread(void *userData) {
+    Bench_ThreadPool *pool = (Bench_ThreadPool *)userData;
+    int32_t generation = 0;
+    pthread_mutex_lock(&pool->mutex);
+    while (true) {
+        while (pool->generation == generation) {
+            pthread_cond_wait(&pool->jobsAvailable, &pool->mutex);
+        }
+        generation = pool->generation;
+        Bench_RunAvailableJobs(pool);
+    }
+    return NULL;
+}
+
+void Bench_RunLayoutJobs(void (*job)(int32_t jobIndex, void *jobData), void *jobData, int32_t jobCount, void *userData) {
+    Bench_ThreadPool *pool = (Bench_ThreadPool *)userData;
+    pthread_mutex_lock(&pool->mutex);
+    pool->job = job;
+    pool->jobData = jobData;
+    pool->jobCount = jobCount;
+    pool->nextJobIndex = 0;
+    pool->completedJobCount = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->jobsAvailable);
+    Bench_RunAvailableJobs(pool);
+    while (pool->completedJobCount < pool->jobCount) {
+        pthread_cond_wait(&pool->jobsCompleted, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+void Bench_EnableParallelLayout(void) {
+    if (!Bench_threadPool.threads[0]) {
+        pthread_mutex_init(&Bench_threadPool.mutex, NULL);
+        pthread_cond_init(&Bench_threadPool.jobsAvailable, NULL);
+        pthread_cond_init(&Bench_threadPool.jobsCompleted, NULL);
+        for (int32_t i = 0; i < BENCH_THREAD_COUNT - 1; ++i) {
+            pthread_create(&Bench_threadPool.threads[i], NULL, Bench_WorkerThread, &Bench_threadPool);
+        }
+    }
+    Clay_SetLayoutJobFunction(Bench_RunLayoutJobs, &Bench_threadPool);
+}
+#else
+// Threads aren't set up on Windows, so the parallel scenarios measure the overhead of splitting layout into jobs
+void Bench_RunLayoutJobs(void (*job)(int32_t jobIndex, void *jobData), void *jobData, int32_t jobCount, void *userData) {
+    (void)userData;
+    for (int32_t i = 0; i < jobCount; ++i) {
+        job(i, jobData);
+    }
+}
+
+void Bench_EnableParallelLayout(void) {
+    Clay_SetLayoutJobFunction(Bench_RunLayoutJobs, NULL);
+}
+#endif
+
+// Bench_Table laid out with Clay_SetLayoutJobFunction. Only sizing is split into jobs, so text wrapping and render command
+// generation still run on the calling thread.
+void Bench_ParallelTable(int32_t size) {
+    Bench_EnableParallelLayout();
+    Bench_Table(size);
+}
+
+// Floating panels that each contain a large subtree, which parallel layout sizes concurrently as independent tree roots
+void Bench_Panels(int32_t size) {
+    Clay_TextElementConfig *textConfig = CLAY_TEXT_CONFIG({ .fontSize = 14, .textColor = { 255, 255, 255, 255 } });
+    CLAY(CLAY_ID("PanelsContainer"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) } }, .backgroundColor = BENCH_COLOR_BACKGROUND }) {
+        for (int32_t panel = 0; panel < 8; ++panel) {
+            CLAY(CLAY_IDI("Panel", panel), {
+                .layout = { .sizing = { CLAY_SIZING_FIXED(300), CLAY_SIZING_FIT(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM },
+                .backgroundColor = BENCH_COLOR_PANEL,
+                .floating = { .attachTo = CLAY_ATTACH_TO_PARENT, .offset = { (float)(panel * 120), (float)(panel * 40) }, .zIndex = (int16_t)panel }
+            }) {
+                for (int32_t item = 0; item < size; ++item) {
+                    CLAY(CLAY_IDI("PanelItem", panel * size + item), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .padding = { 4, 4, 2, 2 } } }) {
+                        CLAY_TEXT(CLAY_STRING("Item"), textConfig);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Bench_LogRow(int32_t index, void *userData) {
+    Clay_TextElementConfig *textConfig = (Clay_TextElementConfig *)userData;
+    CLAY(CLAY_IDI("LogRow", index), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(20) }, .padding = { 4, 4, 2, 2 } } }) {
+        CLAY_TEXT(CLAY_STRING("12:00:00 INFO request handled"), textConfig);
+    }
+}
+
+// A scrolling log viewer, which declares every row
+void Bench_LogRows(int32_t size) {
+    Clay_TextElementConfig *textConfig = CLAY_TEXT_CONFIG({ .fontSize = 14, .textColor = { 255, 255, 255, 255 } });
+    CLAY(CLAY_ID("LogView"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM }, .clip = { .vertical = true, .childOffset = Clay_GetScrollOffset() } }) {
+        for (int32_t row = 0; row < size; ++row) {
+            Bench_LogRow(row, textConfig);
+        }
+    }
+}
+
+// The same log viewer as Bench_LogRows, which only declares the visible rows
+void Bench_VirtualLogRows(int32_t size) {
+    Clay_TextElementConfig *textConfig = CLAY_TEXT_CONFIG({ .fontSize = 14, .textColor = { 255, 255, 255, 255 } });
+    CLAY(CLAY_ID("LogView"), {
+        .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM },
+        .clip = { .vertical = true, .childOffset = Clay_GetScrollOffset() },
+        .virtualList = { .itemCount = size, .itemExtent = 20, .overscan = 2, .declareItem = Bench_LogRow, .userData = textConfig }
+    }) {}
+}
+
+// Times frames of Bench_LogRows scrolled to the middle of the log, where every row above and below the viewport is culled
+void Bench_CulledLogRows(int32_t size, bool cullingEnabled) {
+    Clay_SetCullingEnabled(cullingEnabled);
+    Clay_SetSubtreeCullingEnabled(cullingEnabled);
+    Clay_BeginLayout();
+    Bench_LogRows(size);
+    Clay_EndLayout();
+    Clay_ScrollContainerData scrollData = Clay_GetScrollContainerData(CLAY_ID("LogView"));
+    scrollData.scrollPosition->y = -scrollData.contentDimensions.height / 2;
+    int32_t frameCount = 0;
+    double start = Bench_NowSeconds();
+    double elapsed = 0;
+    while (frameCount < 10 || elapsed < 0.25) {
+        Clay_BeginLayout();
+        Bench_LogRows(size);
+        Clay_EndLayout();
+        frameCount++;
+        elapsed = Bench_NowSeconds() - start;
+    }
+    Clay_CullingStats stats = Clay_GetCullingStats();
+    printf("%-24s %10d %14.2f %10d %10d\n", cullingEnabled ? "culled log rows" : "unculled log rows", size, elapsed * 1e6 / frameCount, stats.culledElementCount, stats.culledRenderCommandCount);
+    scrollData.scrollPosition->y = 0;
+    Clay_SetCullingEnabled(true);
+    Clay_SetSubtreeCullingEnabled(false);
+}
+
+// Reserves, commits and releases the memory of growable arenas, counting the committed bytes
+typedef struct {
+    size_t reservedBytes;
+    size_t committedBytes;
+} Bench_ArenaMemory;
+
+void *Bench_ReserveMemory(size_t size, void *userData) {
+    ((Bench_ArenaMemory *)userData)->reservedBytes = size;
+#ifdef _WIN32
+    return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void *memory = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return memory == MAP_FAILED ? NULL : memory;
+#endif
+}
+
+bool Bench_CommitMemory(void *memory, size_t size, void *userData) {
+    ((Bench_ArenaMemory *)userData)->committedBytes += size;
+#ifdef _WIN32
+    return VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+    return mprotect(memory, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void Bench_ReleaseMemory(void *memory, size_t size, void *userData) {
+    (void)userData;
+#ifdef _WIN32
+    (void)size;
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, size);
+#endif
+}
+
+// Times initializing a context with a large max element count and laying out a Bench_Table of the given size in it,
+// and prints how much of the arena's memory was committed. Fixed arenas commit all of it.
+void Bench_ArenaFirstFrames(int32_t size, bool growable) {
+    Clay_Context *previousContext = Clay_GetCurrentContext();
+    Clay_SetCurrentContext(NULL);
+    Clay_SetMaxElementCount(1 << 20);
+    Clay_SetArrayCapacities((Clay_ArrayCapacities) { 0 });
+    Bench_ArenaMemory memory = { 0 };
+    int32_t frameCount = 0;
+    double start = Bench_NowSeconds();
+    double elapsed = 0;
+    while (frameCount < 10 || elapsed < 0.25) {
+        memory.committedBytes = 0;
+        Clay_Arena arena = { 0 };
+        Clay_Context *context;
+        if (growable) {
+            context = Clay_InitializeGrowable((Clay_ArenaMemoryFunctions) { Bench_ReserveMemory, Bench_CommitMemory, Bench_ReleaseMemory, &memory }, 1 << 20, (Clay_Dimensions) { 1280, 720 }, (Clay_ErrorHandler) { Bench_HandleClayErrors, NULL });
+        } else {
+            arena = Clay_CreateArenaWithCapacityAndMemory(Clay_MinMemorySize(), calloc(Clay_MinMemorySize(), 1));
+            memory.reservedBytes = memory.committedBytes = arena.capacity;
+            context = Clay_Initialize(arena, (Clay_Dimensions) { 1280, 720 }, (Clay_ErrorHandler) { Bench_HandleClayErrors, NULL });
+        }
+        Clay_SetMeasureTextFunction(Bench_MeasureText, NULL);
+        Clay_BeginLayout();
+        Bench_Table(size);
+        Clay_EndLayout();
+        Clay_SetCurrentContext(NULL);
+        if (growable) {
+            Clay_ReleaseGrowable(context);
+        } else {
+            free(arena.memory);
+        }
+        frameCount++;
+        elapsed = Bench_NowSeconds() - start;
+    }
+    printf("%-24s %10d %14.2f %10.2f %10.2f\n", growable ? "growable arena" : "fixed arena", size, elapsed * 1e6 / frameCount, (double)memory.reservedBytes / (1 << 20), (double)memory.committedBytes / (1 << 20));
+    Clay_SetCurrentContext(previousContext);
+}
+
+void Bench_ParallelPanels(int32_t size) {
+    Bench_EnableParallelLayout();
+    Bench_Panels(size);
+}
+
+ClayVideoDemo_Data Bench_videoDemoData;
+
+Bench_Scenario scenarios[] = {
+    { "floating roots", 10, Bench_FloatingRoots },
+    { "floating roots", 100, Bench_FloatingRoots },
+    { "floating roots", 1000, Bench_FloatingRoots },
+    { "table rows", 100, Bench_Table },
+    { "table rows", 1000, Bench_Table },
+    { "table rows", 4000, Bench_Table },
+    { "compressed rows", 400, Bench_CompressedRows },
+    { "wide grow rows", 40, Bench_WideGrowRows },
+    { "deep nesting", 100, Bench_DeepNesting },
+    { "deep nesting", 2000, Bench_DeepNesting },
+    { "paragraphs", 1000, Bench_Paragraphs },
+    { "scroll containers", 96, Bench_ScrollContainers },
+    { "panel items", 2000, Bench_Panels },
+    { "log rows", 100000, Bench_LogRows },
+    { "virtual log rows", 100000, Bench_VirtualLogRows },
+    // Parallel scenarios enable the job function for the rest of the run, so they come last
+    { "parallel table rows", 4000, Bench_ParallelTable },
+    { "parallel panel items", 2000, Bench_ParallelPanels },
+};
+
+// Runs one frame the way an application would, moving the pointer and updating scroll containers before declaring the layout.
+// Returns the number of render commands.
+int32_t Bench_Frame(Bench_Scenario *scenario, int32_t frameIndex) {
+    Clay_SetPointerState((Clay_Vector2) { (float)((frameIndex * 37) % 1280), (float)((frameIndex * 53) % 720) }, frameIndex % 8 == 0);
+    Clay_UpdateScrollContainers(false, (Clay_Vector2) { 0, frameIndex % 16 == 0 ? -1.0f : 0 }, 1.0f / 60);
+    if (scenario) {
+        Clay_BeginLayout();
+        scenario->declareLayout(scenario->size);
+        return Clay_EndLayout().length;
+    }
+    return ClayVideoDemo_CreateLayout(&Bench_videoDemoData).length;
+}
+
+// Times frames of a scenario, or of the video demo layout if scenario is NULL
+void Bench_Frames(Bench_Scenario *scenario) {
+    // Warm up the text measurement cache and the element hash map before timing
+    for (int32_t frame = 0; frame < 3; ++frame) {
+        Bench_Frame(scenario, frame);
+    }
+    int32_t commandCount = 0;
+    int32_t frameCount = 0;
+    double start = Bench_NowSeconds();
+    double elapsed = 0;
+    while (frameCount < 10 || elapsed < 0.25) {
+        commandCount = Bench_Frame(scenario, frameCount);
+        frameCount++;
+        elapsed = Bench_NowSeconds() - start;
+    }
+    int32_t elementCount = Clay_GetMemoryStats().layoutElements.length;
+    double secondsPerFrame = elapsed / frameCount;
+    printf("%-24s %10d %14.2f %14.2f %14.0f %10d %10d\n", scenario ? scenario->name : "video demo", scenario ? scenario->size : 1,
+        secondsPerFrame * 1e6, secondsPerFrame * 1e9 / elementCount, commandCount / secondsPerFrame, elementCount, commandCount);
+}
+
+// Prints the peak usage of the context's arrays across every scenario that ran in it
+void Bench_PrintMemoryStats(void) {
+    Clay_MemoryStats stats = Clay_GetMemoryStats();
+    printf("\n%-24s %10s %10s\n", "array", "peak", "capacity");
+    printf("%-24s %10d %10d\n", "layout elements", stats.layoutElements.highWaterMark, stats.layoutElements.capacity);
+    printf("%-24s %10d %10d\n", "render commands", stats.renderCommands.highWaterMark, stats.renderCommands.capacity);
+    printf("%-24s %10d %10d\n", "element configs", stats.elementConfigs.highWaterMark, stats.elementConfigs.capacity);
+    printf("%-24s %10d %10d\n", "text elements", stats.textElements.highWaterMark, stats.textElements.capacity);
+    printf("%-24s %10d %10d\n", "wrapped text lines", stats.wrappedTextLines.highWaterMark, stats.wrappedTextLines.capacity);
+    printf("%-24s %10d %10d\n", "element ids", stats.elementIds.highWaterMark, stats.elementIds.capacity);
+    printf("%-24s %10d %10d\n", "measured words", stats.measuredWords.highWaterMark, stats.measuredWords.capacity);
+    printf("%-24s %10d %10d\n", "scroll containers", stats.scrollContainers.highWaterMark, stats.scrollContainers.capacity);
+    printf("%-24s %10.2f MB of %.2f MB\n", "arena", (double)stats.arenaBytesUsed / (1 << 20), (double)stats.arenaBytesReserved / (1 << 20));
+}
+
+int main(void) {
+    Bench_CreateContext(1 << 18);
+    Bench_videoDemoData = ClayVideoDemo_Initialize();
+
+    printf("%-24s %10s %14s %14s %14s %10s %10s\n", "scenario", "size", "us / frame", "ns / element", "commands / s", "elements", "commands");
+    Bench_Frames(NULL);
+    for (int32_t i = 0; i < (int32_t)(sizeof(scenarios) / sizeof(scenarios[0])); ++i) {
+        Bench_Frames(&scenarios[i]);
+    }
+    Bench_PrintMemoryStats();
+
+    printf("\n%-24s %10s %14s %10s\n", "scenario", "size", "ns / lookup", "found");
+    Bench_ElementLookups(1000);
+    Bench_ElementLookups(16000);
+    Bench_ElementLookups(128000);
+
+    printf("\n%-24s %10s %14s %10s\n", "scenario", "size", "us / test", "hovered");
+    Bench_PointerHitTests(100);
+    Bench_PointerHitTests(1000);
+    Bench_PointerHitTests(10000);
+
+    printf("\n%-24s %10s %14s %10s\n", "scenario", "size", "us / frame", "changed");
+    Bench_RenderCommandDiffs(1000, false);
+    Bench_RenderCommandDiffs(1000, true);
+
+    printf("\n%-24s %10s %14s %10s %10s\n", "scenario", "size", "us / frame", "elements", "commands");
+    Bench_CulledLogRows(10000, false);
+    Bench_CulledLogRows(10000, true);
+
+    printf("\n%-24s %10s %14s %10s %10s\n", "scenario", "size", "us / frame", "MB total", "MB used");
+    Bench_ArenaFirstFrames(100, false);
+    Bench_ArenaFirstFrames(100, true);
+    Bench_ArenaFirstFrames(4000, true);
+
+    printf("\n%-24s %10s %14s\n", "scenario", "size", "us / layout");
+    Bench_FirstLayouts(1000, false);
+    Bench_FirstLayouts(1000, true);
+    Bench_BoundaryFirstLayouts(1000, false);
+    Bench_BoundaryFirstLayouts(1000, true);
+    return 0;
+}
@@ -144,6 +144,14 @@ ClipElementConfig :: struct {
 	childOffset: Vector2, // offsets the [X,Y] positions of all child elements, primarily for scrolling containers
 }
 
+VirtualListElementConfig :: struct {
+	itemCount:   i32, // total number of items in the list
+	itemExtent:  f32, // size of each item along the element's layoutDirection
+	overscan:    i32, // additional items to declare before and after the visible ones
+	declareItem: proc "c" (index: i32, userData: rawptr), // declares exactly one element for the item at index
+	userData:    rawptr,
+}
+
 FloatingAttachPointType :: enum EnumBackingType {
 	LeftTop,
 	LeftCenter,
@@ -347,6 +355,7 @@ ElementDeclaration :: struct {
 	custom:          CustomElementConfig,
 	clip:            ClipElementConfig,
 	border:          BorderElementConfig,
+	virtualList:     VirtualListElementConfig,
 	userData:        rawptr,
 }
 
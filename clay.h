@@ -21,6 +21,11 @@
 #include <arm_neon.h>
 #endif
 
+// Atomic intrinsics used by the shared text measurement cache
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
 // -----------------------------------------
 // HEADER DECLARATIONS ---------------------
 // -----------------------------------------
@@ -101,7 +106,22 @@
 
 #define CLAY_STRING_CONST(string) { .isStaticallyAllocated = true, .length = CLAY__STRING_LENGTH(CLAY__ENSURE_STRING_LITERAL(string)), .chars = (string) }
 
-static uint8_t CLAY__ELEMENT_DEFINITION_LATCH;
+// Defining CLAY_THREAD_LOCAL_CONTEXT gives every thread its own current context, so that different contexts can lay out on different threads at once
+#ifdef CLAY_THREAD_LOCAL_CONTEXT
+    #if defined(__cplusplus)
+        #define CLAY__THREAD_LOCAL thread_local
+    #elif defined(_MSC_VER)
+        #define CLAY__THREAD_LOCAL __declspec(thread)
+    #elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+        #define CLAY__THREAD_LOCAL _Thread_local
+    #else
+        #define CLAY__THREAD_LOCAL __thread
+    #endif
+#else
+    #define CLAY__THREAD_LOCAL
+#endif
+
+static CLAY__THREAD_LOCAL uint8_t CLAY__ELEMENT_DEFINITION_LATCH;
 
 // GCC marks the above CLAY__ELEMENT_DEFINITION_LATCH as an unused variable for files that include clay.h but don't declare any layout
 // This is to suppress that warning
@@ -211,6 +231,9 @@ typedef struct Clay_StringSlice {
 
 typedef struct Clay_Context Clay_Context;
 
+// A text measurement cache that can be shared between contexts, see Clay_InitializeSharedMeasureTextCache()
+typedef struct Clay_SharedMeasureTextCache Clay_SharedMeasureTextCache;
+
 // Clay_Arena is a memory arena structure that is used by clay to manage its internal allocations.
 // Rather than creating it by hand, it's easier to use Clay_CreateArenaWithCapacityAndMemory()
 typedef struct Clay_Arena {
@@ -219,6 +242,19 @@ typedef struct Clay_Arena {
     char *memory;
 } Clay_Arena;
 
+// Functions that manage virtual memory for a growable arena, see Clay_InitializeGrowable().
+typedef struct Clay_ArenaMemoryFunctions {
+    // Reserves size bytes of address space aligned to 4096 bytes, without necessarily backing it with memory. Returns NULL on failure.
+    void *(*reserveFunction)(size_t size, void *userData);
+    // Backs size bytes of previously reserved address space, starting at memory, with zero initialized memory that can be read and written.
+    // memory and size are always multiples of 4096. Returns false on failure. The same range may be committed more than once.
+    bool (*commitFunction)(void *memory, size_t size, void *userData);
+    // Releases all size bytes of address space returned by reserveFunction, see Clay_ReleaseGrowable(). Optional.
+    void (*releaseFunction)(void *memory, size_t size, void *userData);
+    // A pointer that will be transparently passed through to all three functions.
+    void *userData;
+} Clay_ArenaMemoryFunctions;
+
 typedef struct Clay_Dimensions {
     float width, height;
 } Clay_Dimensions;
@@ -254,6 +290,14 @@ typedef struct
     Clay_ElementId *internalArray;
 } Clay_ElementIdArray;
 
+// A sized array of Clay_BoundingBox.
+typedef struct
+{
+    int32_t capacity;
+    int32_t length;
+    Clay_BoundingBox *internalArray;
+} Clay_BoundingBoxArray;
+
 // Controls the "radius", or corner rounding of elements, including rectangles, borders and images.
 // The rounding is determined by drawing a circle inset into the element corner by (radius, radius) pixels.
 typedef struct Clay_CornerRadius {
@@ -407,6 +451,14 @@ typedef struct Clay_TextElementConfig {
 
 CLAY__WRAPPER_STRUCT(Clay_TextElementConfig);
 
+// A slice of text to be measured by the function provided to Clay_SetMeasureTextBatchFunction.
+typedef struct Clay_TextMeasurementRequest {
+    // The text to measure. As with Clay_SetMeasureTextFunction, this string is not guaranteed to be null terminated.
+    Clay_StringSlice text;
+    // The config of the text element that the slice belongs to.
+    Clay_TextElementConfig *config;
+} Clay_TextMeasurementRequest;
+
 // Aspect Ratio --------------------------------
 
 // Controls various settings related to aspect ratio scaling element.
@@ -535,6 +587,23 @@ typedef struct Clay_ClipElementConfig {
 
 CLAY__WRAPPER_STRUCT(Clay_ClipElementConfig);
 
+// Virtual List -----------------------------
+
+// Controls an element whose children are a long list of items, of which only the ones visible in the element are declared.
+// The element's position along its layoutDirection is taken from .clip.childOffset, usually with Clay_GetScrollOffset().
+typedef struct Clay_VirtualListElementConfig {
+    int32_t itemCount; // The total number of items in the list.
+    // The size of each item along the element's layoutDirection. Items are expected to all have this size, as space for the items
+    // that aren't declared is reserved with it. If it's an estimate, the positions of items and the scrollable size are approximate.
+    float itemExtent;
+    int32_t overscan; // The number of additional items to declare before and after the visible items, e.g. to keep hover state stable.
+    // Called for each item that needs to be declared, in order, as a child of the element. It should declare exactly one element.
+    void (*declareItem)(int32_t index, void *userData);
+    void *userData; // A pointer that will be transparently passed through to declareItem.
+} Clay_VirtualListElementConfig;
+
+CLAY__WRAPPER_STRUCT(Clay_VirtualListElementConfig);
+
 // Border -----------------------------
 
 // Controls the widths of individual element borders.
@@ -668,6 +737,125 @@ typedef struct Clay_ElementData {
     bool found;
 } Clay_ElementData;
 
+// Counts lookups of the per font metrics that Clay measures once and reuses, such as the width of a space character.
+typedef struct Clay_FontMetricsCacheStats {
+    // The number of times that the metrics for a font configuration were already known.
+    int32_t hitCount;
+    // The number of times that the metrics for a font configuration had to be measured.
+    int32_t missCount;
+} Clay_FontMetricsCacheStats;
+
+// Counts the work that visibility culling skipped during the most recent layout calculation.
+typedef struct Clay_CullingStats {
+    // The number of elements that were entirely outside the screen or the region of their enclosing clip elements,
+    // including every element inside a culled subtree.
+    int32_t culledElementCount;
+    // The number of render commands that culled elements and text lines didn't generate. Elements inside a culled subtree
+    // are never visited, so the commands they would have generated aren't included.
+    int32_t culledRenderCommandCount;
+    // The number of culled elements whose descendants were skipped entirely, because they can't be drawn outside the element.
+    // Always 0 unless enabled with Clay_SetSubtreeCullingEnabled.
+    int32_t culledSubtreeCount;
+} Clay_CullingStats;
+
+// Capacities of Clay's internal arrays that don't need an entry for every element, see Clay_SetArrayCapacities().
+typedef struct Clay_ArrayCapacities {
+    // The number of configs attached to elements, with one for each of an element's .floating, .border, etc. and one for each text element.
+    // Defaults to the max element count.
+    int32_t elementConfigs;
+    // Bytes of element configs, e.g. .floating, .border and CLAY_TEXT_CONFIG(), which are packed together. Defaults to 48 bytes per element.
+    int32_t elementConfigBytes;
+    // The number of text elements. Defaults to the max element count.
+    int32_t textElements;
+    // The number of lines of wrapped text. Defaults to the max element count.
+    int32_t wrappedTextLines;
+    // Bytes of strings generated by the debug view. Defaults to the max element count.
+    int32_t debugStringBytes;
+    // The number of render commands that render command diffing and damage tracking can compare between frames. Unlike the others,
+    // defaults to 0, which leaves the memory for both features unallocated. Set it to the max element count to compare any layout.
+    int32_t diffedRenderCommands;
+} Clay_ArrayCapacities;
+
+// The usage of one of Clay's internal arrays, see Clay_GetMemoryStats().
+typedef struct Clay_ArrayStats {
+    // The number of items in use at the end of the most recent layout.
+    int32_t length;
+    // The number of items that currently fit. In a growable arena, this increases as the arena grows.
+    int32_t capacity;
+    // The largest length at the end of any layout since the context was initialized or Clay_ResetMemoryStats was last called.
+    int32_t highWaterMark;
+} Clay_ArrayStats;
+
+// How close a context is to the limits of its memory, see Clay_GetMemoryStats().
+typedef struct Clay_MemoryStats {
+    // Arrays that are rebuilt for every layout
+    Clay_ArrayStats layoutElements;
+    Clay_ArrayStats renderCommands;
+    Clay_ArrayStats elementConfigs;
+    Clay_ArrayStats elementConfigBytes;
+    Clay_ArrayStats textElements;
+    Clay_ArrayStats wrappedTextLines;
+    Clay_ArrayStats treeRoots; // The root element, and every floating element
+    Clay_ArrayStats debugStringBytes;
+    // Arrays that persist between layouts
+    Clay_ArrayStats elementIds; // Every element id that has been declared, which is never reduced
+    Clay_ArrayStats measureTextCacheItems; // Pieces of text in the text measurement cache
+    Clay_ArrayStats measuredWords; // Words in the text measurement cache
+    Clay_ArrayStats wrappedLineCache; // Lines of wrapped text that are reused while the width of their container doesn't change
+    Clay_ArrayStats scrollContainers;
+    Clay_ArrayStats pointerOverIds;
+    Clay_ArrayStats fontMetrics;
+    // Bytes of the arena that are allocated to arrays. Every array is allocated at its full capacity, so this is constant after the first layout.
+    size_t arenaBytesUsed;
+    // The capacity of the arena, which is the size of the reserved address space for a growable arena.
+    size_t arenaBytesReserved;
+    // Bytes of the arena that are backed by memory. Equal to arenaBytesReserved unless the arena is growable.
+    size_t arenaBytesCommitted;
+    // The number of calls to Clay_EndLayout since the context was initialized or Clay_ResetMemoryStats was last called.
+    int32_t layoutCount;
+    // The number of those layouts that ran out of capacity, and rendered an error message instead.
+    int32_t capacityExceededCount;
+    // The number of times a growable arena has grown since the context was initialized or Clay_ResetMemoryStats was last called.
+    int32_t arenaGrowCount;
+} Clay_MemoryStats;
+
+// The phases of a layout that are timed when CLAY_PROFILE is defined, see Clay_SetProfileCallback().
+typedef enum {
+    // From the end of Clay_BeginLayout until Clay_EndLayout starts calculating the layout, including the debug view.
+    // Counts the layout elements that were declared.
+    CLAY_PROFILE_PHASE_DECLARATION,
+    // Calls to the measure text function, which are also timed by the phase that made them. Counts the pieces of text measured.
+    CLAY_PROFILE_PHASE_MEASURE_TEXT,
+    // Sizing and positioning along the X axis. Counts the layout elements.
+    CLAY_PROFILE_PHASE_SIZE_X,
+    // Wrapping text to the width of its container. Counts the text elements.
+    CLAY_PROFILE_PHASE_WRAP_TEXT,
+    // Applying the wrapped heights to parents, and sizing along the Y axis. Counts the layout elements.
+    CLAY_PROFILE_PHASE_SIZE_Y,
+    // Sorting the root and floating elements by z-index. Counts the tree roots.
+    CLAY_PROFILE_PHASE_SORT_Z,
+    // Calculating final positions, culling and generating render commands. Counts the render commands generated.
+    CLAY_PROFILE_PHASE_RENDER_COMMANDS,
+    CLAY_PROFILE_PHASE_COUNT
+} Clay_ProfilePhase;
+
+// The time spent in one phase of a layout. Times are in ticks of CLAY_PROFILE_TIMER(), which are CPU timestamp counter
+// cycles on x86, QueryPerformanceCounter ticks on other Windows targets, and nanoseconds elsewhere (clock() ticks if neither
+// clock_gettime nor timespec_get is available), unless CLAY_PROFILE_TIMER is defined before including clay.h.
+typedef struct Clay_ProfilePhaseStats {
+    // The time that the phase was first entered during the layout, or 0 if it wasn't entered.
+    uint64_t startTicks;
+    // The total time spent in the phase, which may have been entered more than once.
+    uint64_t ticks;
+    // The amount of work done by the phase, see Clay_ProfilePhase.
+    int32_t count;
+} Clay_ProfilePhaseStats;
+
+// The timing of every phase of a single layout, indexed by Clay_ProfilePhase.
+typedef struct Clay_ProfileFrame {
+    Clay_ProfilePhaseStats phases[CLAY_PROFILE_PHASE_COUNT];
+} Clay_ProfileFrame;
+
 // Used by renderers to determine specific handling for each render command.
 typedef CLAY_PACKED_ENUM {
     // This command type should be skipped.
@@ -722,6 +910,22 @@ typedef struct Clay_RenderCommandArray {
     Clay_RenderCommand* internalArray;
 } Clay_RenderCommandArray;
 
+// The changes between the render commands returned by the two most recent calls to Clay_EndLayout, see Clay_GetRenderCommandDiff.
+// Commands are matched between frames by their id, their commandType, and their order among commands with the same id and type,
+// e.g. each wrapped line of a text element. Any change to a matched command, including its bounding box, marks it as modified.
+typedef struct Clay_RenderCommandDiff {
+    // True if the render commands are identical to the previous frame's, in which case all of the arrays below are empty.
+    bool unchanged;
+    // Commands that weren't in the previous frame.
+    Clay_RenderCommandArray inserted;
+    // Copies of commands from the previous frame that aren't in this frame.
+    Clay_RenderCommandArray removed;
+    // Commands that were in the previous frame, but have changed.
+    Clay_RenderCommandArray modified;
+    // Copies of the previous frame's version of each command in modified, at the same index.
+    Clay_RenderCommandArray previousModified;
+} Clay_RenderCommandDiff;
+
 // Represents the current state of interaction with clay this frame.
 typedef CLAY_PACKED_ENUM {
     // A left mouse click, or touch occurred this frame.
@@ -768,6 +972,9 @@ typedef struct Clay_ElementDeclaration {
     Clay_ClipElementConfig clip;
     // Controls settings related to element borders, and will generate BORDER render commands.
     Clay_BorderElementConfig border;
+    // Declares the element's children on demand, so that only the visible items of a long list are laid out.
+    // Note: in order to activate virtualization, .virtualList.declareItem must be set.
+    Clay_VirtualListElementConfig virtualList;
     // A pointer that will be transparently passed through to resulting render commands.
     void *userData;
 } Clay_ElementDeclaration;
@@ -842,6 +1049,16 @@ CLAY_DLL_EXPORT void Clay_SetPointerState(Clay_Vector2 position, bool pointerDow
 // - layoutDimensions are the initial bounding dimensions of the layout (i.e. the screen width and height for a full screen layout)
 // - errorHandler is used by Clay to inform you if something has gone wrong in configuration or layout.
 CLAY_DLL_EXPORT Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler);
+// Initializes Clay in an arena that reserves address space for maxReservedElementCount elements, but only commits memory for the elements
+// that are actually declared. Arrays that run out of space grow in place, so a frame that declares more elements than the max element count
+// isn't lost, up to maxReservedElementCount which becomes the context's max element count.
+// - memoryFunctions reserve, commit and release the arena's memory, e.g. with mmap, mprotect and munmap, or VirtualAlloc and VirtualFree
+// - maxReservedElementCount is the hard limit on elements. Values below the current max element count are raised to it.
+// Returns NULL if the address space couldn't be reserved. The capacities of a growable context can't be changed once it is initialized.
+CLAY_DLL_EXPORT Clay_Context* Clay_InitializeGrowable(Clay_ArenaMemoryFunctions memoryFunctions, int32_t maxReservedElementCount, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler);
+// Releases the address space of a context created with Clay_InitializeGrowable() with its releaseFunction, e.g. after initializing
+// a replacement. Clears the current context if it's the released one. Does nothing for other contexts, or if there is no releaseFunction.
+CLAY_DLL_EXPORT void Clay_ReleaseGrowable(Clay_Context *context);
 // Returns the Context that clay is currently using. Used when using multiple instances of clay simultaneously.
 CLAY_DLL_EXPORT Clay_Context* Clay_GetCurrentContext(void);
 // Sets the context that clay will use to compute the layout.
@@ -894,9 +1111,20 @@ CLAY_DLL_EXPORT Clay_ScrollContainerData Clay_GetScrollContainerData(Clay_Elemen
 // - measureTextFunction is a user provided function that adheres to the interface Clay_Dimensions (Clay_StringSlice text, Clay_TextElementConfig *config, void *userData);
 // - userData is a pointer that will be transparently passed through when the measureTextFunction is called.
 CLAY_DLL_EXPORT void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData), void *userData);
+// Binds a callback function that Clay will call once per layout to measure all text that isn't already cached, instead of calling the
+// function provided to Clay_SetMeasureTextFunction once per word. Useful when every call to the measure function is expensive, e.g. across a language boundary.
+// - measureTextBatchFunction must write the dimensions of requests[i] to dimensions[i] for every i from 0 to requestCount - 1.
+// - userData is a pointer that will be transparently passed through when measureTextBatchFunction is called.
+// Pass NULL to measure text with the function provided to Clay_SetMeasureTextFunction, which is the default.
+CLAY_DLL_EXPORT void Clay_SetMeasureTextBatchFunction(void (*measureTextBatchFunction)(const Clay_TextMeasurementRequest *requests, Clay_Dimensions *dimensions, int32_t requestCount, void *userData), void *userData);
 // Experimental - Used in cases where Clay needs to integrate with a system that manages its own scrolling containers externally.
 // Please reach out if you plan to use this function, as it may be subject to change.
 CLAY_DLL_EXPORT void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData), void *userData);
+// Enables multithreaded layout, where independent subtrees and floating roots of large layouts are sized concurrently using a user provided job system.
+// - runJobsFunction will be called from Clay_EndLayout, and must call job(jobIndex, jobData) exactly once for every jobIndex from 0 to jobCount - 1,
+//   in any order and on any threads, then return once all of them have completed. Pass NULL to lay out on the calling thread only, which is the default.
+// - userData is a pointer that will be transparently passed through when runJobsFunction is called.
+CLAY_DLL_EXPORT void Clay_SetLayoutJobFunction(void (*runJobsFunction)(void (*job)(int32_t jobIndex, void *jobData), void *jobData, int32_t jobCount, void *userData), void *userData);
 // A bounds-checked "get" function for the Clay_RenderCommandArray returned from Clay_EndLayout().
 CLAY_DLL_EXPORT Clay_RenderCommand * Clay_RenderCommandArray_Get(Clay_RenderCommandArray* array, int32_t index);
 // Enables and disables Clay's internal debug tools.
@@ -904,20 +1132,82 @@ CLAY_DLL_EXPORT Clay_RenderCommand * Clay_RenderCommandArray_Get(Clay_RenderComm
 CLAY_DLL_EXPORT void Clay_SetDebugModeEnabled(bool enabled);
 // Returns true if Clay's internal debug tools are currently enabled.
 CLAY_DLL_EXPORT bool Clay_IsDebugModeEnabled(void);
-// Enables and disables visibility culling. By default, Clay will not generate render commands for elements whose bounding box is entirely outside the screen.
+// Enables and disables visibility culling. By default, Clay will not generate render commands for elements whose bounding box is entirely outside the screen
+// or the region of their enclosing clip elements.
 CLAY_DLL_EXPORT void Clay_SetCullingEnabled(bool enabled);
+// Enables and disables skipping the descendants of culled elements that can't be drawn outside the element, which is disabled by default.
+// Elements inside a skipped subtree keep the bounding box from the last layout that positioned them, so Clay_GetElementData, Clay_PointerOver
+// and scrolling to them use stale positions until they're visited again. Has no effect while culling is disabled.
+CLAY_DLL_EXPORT void Clay_SetSubtreeCullingEnabled(bool enabled);
+// Returns the number of elements and render commands that were culled by the most recent layout calculation.
+CLAY_DLL_EXPORT Clay_CullingStats Clay_GetCullingStats(void);
+// Enables and disables whole-frame layout caching. When enabled, Clay_EndLayout will skip layout calculation entirely and return the previous
+// frame's render commands if every element declaration, text string and the layout dimensions are identical to the previous frame.
+// Individual subtrees aren't reused, so any change to the declaration, e.g. a hover color, recalculates the entire layout.
+// The returned render command array must be treated as read only while layout caching is enabled.
+CLAY_DLL_EXPORT void Clay_SetLayoutCachingEnabled(bool enabled);
+// Enables and disables render command diffing. When enabled, Clay_EndLayout compares its render commands with the previous frame's,
+// and the result can be read with Clay_GetRenderCommandDiff. The first frame after diffing is enabled reports every command as inserted.
+// Requires memory that is only allocated if Clay_SetArrayCapacities() was called with a .diffedRenderCommands before initialization,
+// without which an error is reported and diffing stays disabled.
+CLAY_DLL_EXPORT void Clay_SetRenderCommandDiffingEnabled(bool enabled);
+// Returns the changes between the render commands returned by the most recent call to Clay_EndLayout and the call before it.
+// The arrays are valid until the next call to Clay_BeginLayout, and are empty if render command diffing is disabled.
+CLAY_DLL_EXPORT Clay_RenderCommandDiff Clay_GetRenderCommandDiff(void);
+// Enables and disables damage tracking. When enabled, Clay_EndLayout calculates the areas of the screen that need to be redrawn
+// since the previous frame, which can be read with Clay_GetDamageRectangles. Requires a .diffedRenderCommands, as with diffing,
+// without which an error is reported and damage tracking stays disabled.
+CLAY_DLL_EXPORT void Clay_SetDamageTrackingEnabled(bool enabled);
+// Returns the areas of the screen that have changed between the two most recent calls to Clay_EndLayout, clamped to the layout dimensions.
+// Empty if nothing has changed, and covers the entire layout on the first frame after damage tracking is enabled.
+// The array is valid until the next call to Clay_BeginLayout, and is empty if damage tracking is disabled.
+CLAY_DLL_EXPORT Clay_BoundingBoxArray Clay_GetDamageRectangles(void);
 // Returns the maximum number of UI elements supported by Clay's current configuration.
 CLAY_DLL_EXPORT int32_t Clay_GetMaxElementCount(void);
 // Modifies the maximum number of UI elements supported by Clay's current configuration.
-// This may require reallocating additional memory, and re-calling Clay_Initialize();
+// This may require reallocating additional memory, and re-calling Clay_Initialize(). Growable contexts can't be changed.
 CLAY_DLL_EXPORT void Clay_SetMaxElementCount(int32_t maxElementCount);
 // Returns the maximum number of measured "words" (whitespace seperated runs of characters) that Clay can store in its internal text measurement cache.
 CLAY_DLL_EXPORT int32_t Clay_GetMaxMeasureTextCacheWordCount(void);
 // Modifies the maximum number of measured "words" (whitespace seperated runs of characters) that Clay can store in its internal text measurement cache.
-// This may require reallocating additional memory, and re-calling Clay_Initialize();
+// This may require reallocating additional memory, and re-calling Clay_Initialize(). Growable contexts can't be changed.
 CLAY_DLL_EXPORT void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount);
+// Returns the capacities of the internal arrays that don't need an entry for every element in Clay's current configuration.
+CLAY_DLL_EXPORT Clay_ArrayCapacities Clay_GetArrayCapacities(void);
+// Modifies the capacities of the internal arrays that don't need an entry for every element. Capacities of 0 are replaced by defaults
+// derived from the max element count, except for .diffedRenderCommands. The current context uses them from its next layout, unless they
+// don't fit in its arena, in which case an error is reported and nothing changes. Its .diffedRenderCommands is fixed when it's initialized.
+// They're also used by subsequent calls to Clay_Initialize() and Clay_MinMemorySize(). Growable contexts can't be changed.
+CLAY_DLL_EXPORT void Clay_SetArrayCapacities(Clay_ArrayCapacities capacities);
+// Shorthand for the highWaterMark of each of those arrays in Clay_GetMemoryStats, in the form taken by Clay_SetArrayCapacities, which
+// can be used to tune their capacities for a real workload. They are reset by Clay_ResetMemoryStats. .diffedRenderCommands is the
+// highWaterMark of the render commands, or 0 if the context wasn't initialized with a .diffedRenderCommands.
+CLAY_DLL_EXPORT Clay_ArrayCapacities Clay_GetArrayHighWaterMarks(void);
+// Returns the length, capacity and high water mark of Clay's internal arrays, and how much of the arena is used.
+// The stats are updated by Clay_EndLayout, and are cheap enough to collect every frame.
+CLAY_DLL_EXPORT Clay_MemoryStats Clay_GetMemoryStats(void);
+// Resets the high water marks and counters returned by Clay_GetMemoryStats.
+CLAY_DLL_EXPORT void Clay_ResetMemoryStats(void);
+// Sets a function that is called at the end of every Clay_EndLayout with the timing of each phase of the layout, e.g. to forward
+// them to a profiler or store them in a ring buffer. Phases are only timed when CLAY_PROFILE is defined where the implementation is compiled.
+// - userData is a pointer that will be transparently passed through when profileFunction is called.
+CLAY_DLL_EXPORT void Clay_SetProfileCallback(void (*profileFunction)(const Clay_ProfileFrame *frame, void *userData), void *userData);
+// Returns the timing of each phase of the most recent layout. All zeros unless CLAY_PROFILE is defined.
+CLAY_DLL_EXPORT Clay_ProfileFrame Clay_GetProfileFrame(void);
 // Resets Clay's internal text measurement cache. Useful if font mappings have changed or fonts have been reloaded.
 CLAY_DLL_EXPORT void Clay_ResetMeasureTextCache(void);
+// Returns the number of font metrics cache hits and misses since the context was initialized or Clay_ResetMeasureTextCache was last called.
+CLAY_DLL_EXPORT Clay_FontMetricsCacheStats Clay_GetFontMetricsCacheStats(void);
+// Returns the size, in bytes, of the memory required by a shared text measurement cache that can store maxWordCount measured words.
+CLAY_DLL_EXPORT uint32_t Clay_MinSharedMeasureTextCacheMemorySize(int32_t maxWordCount);
+// Initializes a text measurement cache in the provided arena, which can be attached to any number of contexts. Returns NULL if the arena is too small.
+CLAY_DLL_EXPORT Clay_SharedMeasureTextCache* Clay_InitializeSharedMeasureTextCache(Clay_Arena arena, int32_t maxWordCount);
+// Attaches a shared text measurement cache to the current context, or detaches it if cache is NULL. Text measured by any attached context
+// is reused by all of them, so they must measure text the same way, e.g. by using the same fonts for the same font ids.
+// Attached contexts can measure text concurrently on different threads, see CLAY_THREAD_LOCAL_CONTEXT.
+CLAY_DLL_EXPORT void Clay_SetSharedMeasureTextCache(Clay_SharedMeasureTextCache *cache);
+// Removes every measurement from a shared text measurement cache. Must not be called while an attached context is laying out.
+CLAY_DLL_EXPORT void Clay_ResetSharedMeasureTextCache(Clay_SharedMeasureTextCache *cache);
 
 // Internal API functions required by macros ----------------------
 
@@ -955,6 +1245,56 @@ extern uint32_t Clay__debugViewWidth;
 #define CLAY__MAXFLOAT 3.40282346638528859812e+38F
 #endif
 
+// Profiling hooks, which are placed around each Clay_ProfilePhase. By default they record the timing returned by
+// Clay_GetProfileFrame. CLAY_PROFILE_BEGIN and CLAY_PROFILE_END can be defined before including the implementation to forward
+// phases to an external profiler instead. The BEGIN and END of one phase may be in different functions.
+#ifdef CLAY_PROFILE
+#ifndef CLAY_PROFILE_TIMER
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64) || defined(__i386__) || defined(_M_IX86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define CLAY_PROFILE_TIMER() ((uint64_t)__rdtsc())
+#elif defined(_WIN32)
+#include <windows.h>
+static inline uint64_t Clay__ProfileTimer(void) {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)counter.QuadPart;
+}
+#define CLAY_PROFILE_TIMER() Clay__ProfileTimer()
+#else
+// clock_gettime is only declared by POSIX, so define _POSIX_C_SOURCE as 199309L or later before including clay.h in strict C99 builds
+#include <time.h>
+#if defined(CLOCK_MONOTONIC) || defined(TIME_UTC)
+static inline uint64_t Clay__ProfileTimer(void) {
+    struct timespec time;
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &time);
+#else
+    timespec_get(&time, TIME_UTC);
+#endif
+    return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+}
+#define CLAY_PROFILE_TIMER() Clay__ProfileTimer()
+#else
+#define CLAY_PROFILE_TIMER() ((uint64_t)clock())
+#endif
+#endif
+#endif
+#ifndef CLAY_PROFILE_BEGIN
+#define CLAY_PROFILE_BEGIN(phase) Clay__ProfileBegin(phase)
+#endif
+#ifndef CLAY_PROFILE_END
+#define CLAY_PROFILE_END(phase, count) Clay__ProfileEnd(phase, count)
+#endif
+#else
+#define CLAY_PROFILE_BEGIN(phase)
+#define CLAY_PROFILE_END(phase, count)
+#endif
+
 Clay_LayoutConfig CLAY_LAYOUT_DEFAULT = CLAY__DEFAULT_STRUCT;
 
 Clay_Color Clay__Color_DEFAULT = CLAY__DEFAULT_STRUCT;
@@ -986,7 +1326,7 @@ typeName arrayName##_GetValue(arrayName *array, int32_t index) {
 }                                                                                                               \
                                                                                                                 \
 typeName *arrayName##_Add(arrayName *array, typeName item) {                                                    \
-    if (Clay__Array_AddCapacityCheck(array->length, array->capacity)) {                                         \
+    if (Clay__Array_AddCapacityCheck(array->length, &array->capacity)) {                                        \
         array->internalArray[array->length++] = item;                                                           \
         return &array->internalArray[array->length - 1];                                                        \
     }                                                                                                           \
@@ -1024,9 +1364,10 @@ typedef struct                                      \
                                                     \
 CLAY__ARRAY_DEFINE_FUNCTIONS(typeName, arrayName)   \
 
-Clay_Context *Clay__currentContext;
+CLAY__THREAD_LOCAL Clay_Context *Clay__currentContext;
 int32_t Clay__defaultMaxElementCount = 8192;
 int32_t Clay__defaultMaxMeasureTextWordCacheCount = 16384;
+Clay_ArrayCapacities Clay__defaultArrayCapacities = CLAY__DEFAULT_STRUCT;
 
 void Clay__ErrorHandlerFunctionDefault(Clay_ErrorData errorText) {
     (void) errorText;
@@ -1067,12 +1408,14 @@ Clay__WarningArray Clay__WarningArray_Allocate_Arena(int32_t capacity, Clay_Aren
 Clay__Warning *Clay__WarningArray_Add(Clay__WarningArray *array, Clay__Warning item);
 void* Clay__Array_Allocate_Arena(int32_t capacity, uint32_t itemSize, Clay_Arena *arena);
 bool Clay__Array_RangeCheck(int32_t index, int32_t length);
-bool Clay__Array_AddCapacityCheck(int32_t length, int32_t capacity);
+bool Clay__Array_AddCapacityCheck(int32_t length, int32_t *capacity);
 
 CLAY__ARRAY_DEFINE(bool, Clay__boolArray)
 CLAY__ARRAY_DEFINE(int32_t, Clay__int32_tArray)
 CLAY__ARRAY_DEFINE(char, Clay__charArray)
+CLAY__ARRAY_DEFINE(Clay_Dimensions, Clay__DimensionsArray)
 CLAY__ARRAY_DEFINE_FUNCTIONS(Clay_ElementId, Clay_ElementIdArray)
+CLAY__ARRAY_DEFINE_FUNCTIONS(Clay_BoundingBox, Clay_BoundingBoxArray)
 CLAY__ARRAY_DEFINE(Clay_LayoutConfig, Clay__LayoutConfigArray)
 CLAY__ARRAY_DEFINE(Clay_TextElementConfig, Clay__TextElementConfigArray)
 CLAY__ARRAY_DEFINE(Clay_AspectRatioElementConfig, Clay__AspectRatioElementConfigArray)
@@ -1175,19 +1518,36 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__DebugElementData, Clay__DebugElementDataArray)
 
-typedef struct { // todo get this struct into a single cache line
+// Only the data needed for lookups and layout is kept here, so that two items fit in a single cache line
+typedef struct {
     Clay_BoundingBox boundingBox;
-    Clay_ElementId elementId;
     Clay_LayoutElement* layoutElement;
-    void (*onHoverFunction)(Clay_ElementId elementId, Clay_PointerData pointerInfo, void *userData);
-    void *hoverFunctionUserData;
-    int32_t nextIndex;
+    uint32_t id;
     uint32_t generation;
-    Clay__DebugElementData *debugData;
 } Clay_LayoutElementHashMapItem;
 
 CLAY__ARRAY_DEFINE(Clay_LayoutElementHashMapItem, Clay__LayoutElementHashMapItemArray)
 
+// Rarely accessed item data, stored at the same index as its Clay_LayoutElementHashMapItem
+typedef struct {
+    Clay_ElementId elementId;
+    void (*onHoverFunction)(Clay_ElementId elementId, Clay_PointerData pointerInfo, void *userData);
+    void *hoverFunctionUserData;
+} Clay__LayoutElementHashMapItemColdData;
+
+CLAY__ARRAY_DEFINE(Clay__LayoutElementHashMapItemColdData, Clay__LayoutElementHashMapItemColdDataArray)
+
+#define CLAY__HASH_MAP_GROUP_SIZE 16
+
+// Open addressing buckets, probed a group at a time. Each tag is either 0 for an empty slot,
+// or the high bit set plus 7 bits of the id's hash, so that most mismatches are rejected without touching the items.
+typedef struct {
+    uint8_t tags[CLAY__HASH_MAP_GROUP_SIZE];
+    int32_t itemIndexes[CLAY__HASH_MAP_GROUP_SIZE];
+} Clay__LayoutElementHashMapGroup;
+
+CLAY__ARRAY_DEFINE(Clay__LayoutElementHashMapGroup, Clay__LayoutElementHashMapGroupArray)
+
 typedef struct {
     int32_t startOffset;
     int32_t length;
@@ -1197,11 +1557,28 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__MeasuredWord, Clay__MeasuredWordArray)
 
+// A line of text that was wrapped at the cached width, stored as a list in the same way as measured words
+typedef struct {
+    int32_t startOffset;
+    int32_t length;
+    float width;
+    int32_t next;
+} Clay__CachedWrappedLine;
+
+CLAY__ARRAY_DEFINE(Clay__CachedWrappedLine, Clay__CachedWrappedLineArray)
+
 typedef struct {
     Clay_Dimensions unwrappedDimensions;
     int32_t measuredWordsStartIndex;
     float minWidth;
     bool containsNewlines;
+    bool inSharedCache; // If true, measuredWordsStartIndex refers to the measured words of the context's shared cache
+    bool measurementPending; // Waiting to be measured in a batch, see Clay__MeasurePendingText
+    float spaceWidth;
+    // The lines from the last time the text was wrapped, which are reused while the width of its container doesn't change
+    float wrappedWidth;
+    int32_t wrappedLinesStartIndex;
+    int32_t wrappedLineCount; // 0 if no lines are cached
     // Hash map data
     uint32_t id;
     int32_t nextIndex;
@@ -1210,10 +1587,73 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__MeasureTextCacheItem, Clay__MeasureTextCacheItemArray)
 
+#define CLAY__FONT_METRICS_CAPACITY 64
+
+// Metrics that only depend on the font configuration, measured once rather than for every piece of text
+typedef struct {
+    uint16_t fontId;
+    uint16_t fontSize;
+    uint16_t letterSpacing;
+    bool measured;
+    bool measurementRequested; // The space character is in the current text measurement batch
+    Clay_Dimensions spaceDimensions;
+} Clay__FontMetrics;
+
+CLAY__ARRAY_DEFINE(Clay__FontMetrics, Clay__FontMetricsArray)
+
+// Identifies a render command between frames, and summarizes its contents so that it can be compared without the previous frame's data
+typedef struct {
+    uint64_t contentHash;
+    uint32_t id;
+    int32_t occurrence; // The number of commands with the same id and type directly before this one
+    int32_t clipIndex; // The index of the enclosing scissor start command, or -1. For scissor start commands, the enclosing one.
+    Clay_BoundingBox visibleBoundingBox; // The bounding box clipped by all enclosing scissor commands
+    int32_t hashMapSlot; // The slot of renderCommandDiffHashMap that indexes this command while it's the previous frame's, or -1
+    Clay_RenderCommandType commandType;
+    bool matched;
+    bool changed; // Inserted, removed or modified
+} Clay__RenderCommandSnapshot;
+
+#define CLAY__MAX_DAMAGE_RECTANGLES 16
+
+CLAY__ARRAY_DEFINE(Clay__RenderCommandSnapshot, Clay__RenderCommandSnapshotArray)
+
+typedef struct {
+    Clay_String text;
+    Clay_TextElementConfig *config;
+    int32_t cacheItemIndex;
+    int32_t sharedCacheItemIndex; // -1 unless the measurement will be published to the context's shared cache
+    int32_t requestCount; // -1 if the text has too many words to be measured in a single batch
+} Clay__PendingTextMeasurement;
+
+CLAY__ARRAY_DEFINE(Clay__PendingTextMeasurement, Clay__PendingTextMeasurementArray)
+CLAY__ARRAY_DEFINE(Clay_TextMeasurementRequest, Clay__TextMeasurementRequestArray)
+
+typedef enum {
+    CLAY__SHARED_MEASUREMENT_STATE_PENDING, // Claimed by a context that is still measuring the text
+    CLAY__SHARED_MEASUREMENT_STATE_READY,
+    CLAY__SHARED_MEASUREMENT_STATE_FAILED, // The cache ran out of space for the measured words, so every context measures this text itself
+} Clay__SharedMeasurementState;
+
+// An insert only, open addressed hash map of measurements. Items are claimed by setting their id with a compare and swap, and become
+// visible to other threads once their state is set to ready. Measured words are allocated by advancing measuredWordCount with a compare and swap.
+// Nothing is removed until Clay_ResetSharedMeasureTextCache, so readers never need a lock.
+struct Clay_SharedMeasureTextCache {
+    int32_t itemCapacity; // Always a power of two
+    int32_t maxWordCount;
+    volatile uint32_t *itemIds; // Zero means the item is empty
+    volatile uint32_t *itemStates;
+    Clay__MeasureTextCacheItem *items;
+    Clay__MeasuredWord *measuredWords;
+    volatile uint32_t measuredWordCount; // Never exceeds maxWordCount
+};
+
 typedef struct {
     Clay_LayoutElement *layoutElement;
     Clay_Vector2 position;
     Clay_Vector2 nextChildOffset;
+    Clay_BoundingBox cullRect; // The visible region the element is culled against, narrowed to the region its children are culled against once visited
+    bool offscreen;
 } Clay__LayoutElementTreeNode;
 
 CLAY__ARRAY_DEFINE(Clay__LayoutElementTreeNode, Clay__LayoutElementTreeNodeArray)
@@ -1224,13 +1664,109 @@ typedef struct {
     uint32_t clipElementId; // This can be zero if there is no clip element
     int16_t zIndex;
     Clay_Vector2 pointerOffset; // Only used when scroll containers are managed externally
+    int32_t parentRootIndex; // The tree containing the floating parent, only calculated for parallel layout
 } Clay__LayoutElementTreeRoot;
 
 CLAY__ARRAY_DEFINE(Clay__LayoutElementTreeRoot, Clay__LayoutElementTreeRootArray)
 
+typedef struct {
+    Clay_BoundingBox boundingBox;
+    // The union of this element's bounding box and those of all its non floating descendants, as edges rather than a size
+    // so that a point inside any of those bounding boxes is guaranteed to compare as inside it
+    Clay_Vector2 subtreeMin;
+    Clay_Vector2 subtreeMax;
+    bool childrenOrdered; // True if the children's subtree bounds don't overlap along the layout axis, so they can be binary searched
+    bool subtreeCulled; // True if culling skipped this element's descendants, so their bounds are out of date
+} Clay__ElementHitTestBounds;
+
+CLAY__ARRAY_DEFINE(Clay__ElementHitTestBounds, Clay__ElementHitTestBoundsArray)
+
+// The children of one parent whose size can change while distributing space along an axis. Their sizes and limits are
+// stored in parallel arrays, so that the distribution loops scan contiguous floats rather than whole layout elements.
+typedef struct {
+    int32_t capacity;
+    int32_t length;
+    int32_t *elementIndexes;
+    float *sizes;
+    float *minSizes;
+    float *maxSizes;
+    Clay__SizingType *sizingTypes;
+} Clay__ResizableContainerBuffer;
+
+Clay__ResizableContainerBuffer Clay__ResizableContainerBuffer_Allocate_Arena(int32_t capacity, Clay_Arena *arena) {
+    Clay__ResizableContainerBuffer buffer = { .capacity = capacity, .length = 0 };
+    buffer.elementIndexes = (int32_t *)Clay__Array_Allocate_Arena(capacity, sizeof(int32_t), arena);
+    buffer.sizes = (float *)Clay__Array_Allocate_Arena(capacity, sizeof(float), arena);
+    buffer.minSizes = (float *)Clay__Array_Allocate_Arena(capacity, sizeof(float), arena);
+    buffer.maxSizes = (float *)Clay__Array_Allocate_Arena(capacity, sizeof(float), arena);
+    buffer.sizingTypes = (Clay__SizingType *)Clay__Array_Allocate_Arena(capacity, sizeof(Clay__SizingType), arena);
+    return buffer;
+}
+
+// A sub range of the buffer's storage, so that concurrent layout jobs don't share entries
+Clay__ResizableContainerBuffer Clay__ResizableContainerBuffer_Slice(Clay__ResizableContainerBuffer *buffer, int32_t offset, int32_t capacity) {
+    Clay__ResizableContainerBuffer slice = { .capacity = capacity, .length = 0 };
+    slice.elementIndexes = buffer->elementIndexes + offset;
+    slice.sizes = buffer->sizes + offset;
+    slice.minSizes = buffer->minSizes + offset;
+    slice.maxSizes = buffer->maxSizes + offset;
+    slice.sizingTypes = buffer->sizingTypes + offset;
+    return slice;
+}
+
+void Clay__ResizableContainerBuffer_Add(Clay__ResizableContainerBuffer *buffer, int32_t elementIndex, float size, float minSize, float maxSize, Clay__SizingType sizingType) {
+    if (Clay__Array_AddCapacityCheck(buffer->length, &buffer->capacity)) {
+        buffer->elementIndexes[buffer->length] = elementIndex;
+        buffer->sizes[buffer->length] = size;
+        buffer->minSizes[buffer->length] = minSize;
+        buffer->maxSizes[buffer->length] = maxSize;
+        buffer->sizingTypes[buffer->length] = sizingType;
+        buffer->length++;
+    }
+}
+
+// Swaps the entry with the last one rather than overwriting it, so that its size can still be written back once distribution is done
+void Clay__ResizableContainerBuffer_RemoveSwapback(Clay__ResizableContainerBuffer *buffer, int32_t index) {
+    int32_t last = --buffer->length;
+    int32_t elementIndex = buffer->elementIndexes[index];
+    float size = buffer->sizes[index], minSize = buffer->minSizes[index], maxSize = buffer->maxSizes[index];
+    Clay__SizingType sizingType = buffer->sizingTypes[index];
+    buffer->elementIndexes[index] = buffer->elementIndexes[last];
+    buffer->sizes[index] = buffer->sizes[last];
+    buffer->minSizes[index] = buffer->minSizes[last];
+    buffer->maxSizes[index] = buffer->maxSizes[last];
+    buffer->sizingTypes[index] = buffer->sizingTypes[last];
+    buffer->elementIndexes[last] = elementIndex;
+    buffer->sizes[last] = size;
+    buffer->minSizes[last] = minSize;
+    buffer->maxSizes[last] = maxSize;
+    buffer->sizingTypes[last] = sizingType;
+}
+
+// An array in a growable arena, which has address space reserved for maxCapacity items but only commits memory for a share of them
+// in proportion to the context's element capacity. All of them grow in place together, so arrays indexed by element stay the same size.
+typedef struct {
+    int32_t *capacity;
+    int32_t *length; // Only set for arrays that are accessed directly, whose length is always their capacity
+    char *memory;
+    uint32_t itemSize;
+    int32_t maxCapacity;
+} Clay__GrowableArray;
+
+CLAY__ARRAY_DEFINE(Clay__GrowableArray, Clay__GrowableArrayArray)
+
+#define CLAY__MAX_GROWABLE_ARRAYS 64
+#define CLAY__ARENA_PAGE_SIZE 4096
+#define CLAY__GROWABLE_INITIAL_ELEMENT_COUNT 1024
+#define CLAY__ELEMENT_CONFIG_ALIGNMENT 8
+#define CLAY__DEFAULT_ELEMENT_CONFIG_BYTES_PER_ELEMENT 48
+
 struct Clay_Context {
     int32_t maxElementCount;
     int32_t maxMeasureTextCacheWordCount;
+    int32_t elementCapacity; // The number of elements that growable arrays currently have memory for, which is maxElementCount unless the arena is growable
+    Clay_ArrayCapacities arrayCapacities; // As set by the user, with 0 for defaults
+    Clay_MemoryStats memoryStats; // Only high water marks and counters are stored, the rest is read from the arrays
     bool warningsEnabled;
     Clay_ErrorHandler errorHandler;
     Clay_BooleanWarnings booleanWarnings;
@@ -1242,13 +1778,33 @@ struct Clay_Context {
     uint32_t dynamicElementIndex;
     bool debugModeEnabled;
     bool disableCulling;
+    bool subtreeCullingEnabled;
     bool externalScrollHandlingEnabled;
+    bool layoutCachingEnabled;
+    bool layoutCacheValid;
+    bool hitTestBoundsValid;
+    bool renderCommandDiffingEnabled;
+    bool damageTrackingEnabled;
+    bool renderCommandSnapshotsValid;
     uint32_t debugSelectedElementId;
     uint32_t generation;
     uintptr_t arenaResetOffset;
     void *measureTextUserData;
+    Clay_SharedMeasureTextCache *sharedMeasureTextCache;
     void *queryScrollOffsetUserData;
+    void (*layoutJobFunction)(void (*job)(int32_t jobIndex, void *jobData), void *jobData, int32_t jobCount, void *userData);
+    void *layoutJobUserData;
+    void (*measureTextBatchFunction)(const Clay_TextMeasurementRequest *requests, Clay_Dimensions *dimensions, int32_t requestCount, void *userData);
+    void *measureTextBatchUserData;
+    int32_t textMeasurementResultIndex; // The next batch result to read while measuring pending text, or -1 to call the measure text function directly
+    bool textMeasurementBatchingPaused;
+    uint64_t layoutInputHash;
+    uint64_t previousLayoutInputHash;
+    int32_t cachedRenderCommandsLength;
     Clay_Arena internalArena;
+    Clay_ArenaMemoryFunctions arenaMemoryFunctions; // Only set if the arena is growable
+    Clay__GrowableArrayArray growableArrays;
+    int32_t persistentGrowableArrayCount;
     // Layout Elements / Render Commands
     Clay_LayoutElementArray layoutElements;
     Clay_RenderCommandArray renderCommands;
@@ -1259,37 +1815,57 @@ struct Clay_Context {
     Clay__int32_tArray aspectRatioElementIndexes;
     Clay__int32_tArray reusableElementIndexBuffer;
     Clay__int32_tArray layoutElementClipElementIds;
+    Clay__int32_tArray layoutElementSubtreeSizes;
+    Clay__boolArray layoutElementSubtreeContained;
+    Clay__ResizableContainerBuffer resizableContainerBuffer;
     // Configs
     Clay__LayoutConfigArray layoutConfigs;
     Clay__ElementConfigArray elementConfigs;
-    Clay__TextElementConfigArray textElementConfigs;
-    Clay__AspectRatioElementConfigArray aspectRatioElementConfigs;
-    Clay__ImageElementConfigArray imageElementConfigs;
-    Clay__FloatingElementConfigArray floatingElementConfigs;
-    Clay__ClipElementConfigArray clipElementConfigs;
-    Clay__CustomElementConfigArray customElementConfigs;
-    Clay__BorderElementConfigArray borderElementConfigs;
-    Clay__SharedElementConfigArray sharedElementConfigs;
+    Clay__charArray elementConfigPool; // Every type of element config other than layout configs, bump allocated and aligned to CLAY__ELEMENT_CONFIG_ALIGNMENT
     // Misc Data Structures
     Clay__StringArray layoutElementIdStrings;
     Clay__WrappedTextLineArray wrappedTextLines;
     Clay__LayoutElementTreeNodeArray layoutElementTreeNodeArray1;
     Clay__LayoutElementTreeRootArray layoutElementTreeRoots;
     Clay__LayoutElementHashMapItemArray layoutElementsHashMapInternal;
-    Clay__int32_tArray layoutElementsHashMap;
+    Clay__LayoutElementHashMapItemColdDataArray layoutElementsHashMapColdData;
+    Clay__LayoutElementHashMapGroupArray layoutElementsHashMap;
     Clay__MeasureTextCacheItemArray measureTextHashMapInternal;
     Clay__int32_tArray measureTextHashMapInternalFreeList;
     Clay__int32_tArray measureTextHashMap;
     Clay__MeasuredWordArray measuredWords;
     Clay__int32_tArray measuredWordsFreeList;
+    Clay__CachedWrappedLineArray cachedWrappedLines;
+    Clay__int32_tArray cachedWrappedLinesFreeList;
+    Clay__PendingTextMeasurementArray pendingTextMeasurements;
+    Clay__FontMetricsArray fontMetrics;
+    Clay_FontMetricsCacheStats fontMetricsCacheStats;
+    Clay_CullingStats cullingStats;
+    Clay_ProfileFrame profileFrame;
+    uint64_t profilePhaseStartTicks[CLAY_PROFILE_PHASE_COUNT];
+    void (*profileFunction)(const Clay_ProfileFrame *frame, void *userData);
+    void *profileUserData;
+    Clay__TextMeasurementRequestArray textMeasurementRequests;
+    Clay__DimensionsArray textMeasurementResults;
     Clay__int32_tArray openClipElementStack;
     Clay_ElementIdArray pointerOverIds;
     Clay__ScrollContainerDataInternalArray scrollContainerDatas;
     Clay__boolArray treeNodeVisited;
+    Clay__ElementHitTestBoundsArray layoutElementHitTestBounds;
     Clay__charArray dynamicStringData;
     Clay__DebugElementDataArray debugElementData;
+    Clay__DimensionsArray cachedLayoutElementDimensions;
+    Clay_RenderCommandArray previousRenderCommands;
+    Clay__RenderCommandSnapshotArray renderCommandSnapshots;
+    Clay__RenderCommandSnapshotArray previousRenderCommandSnapshots;
+    Clay__int32_tArray renderCommandDiffHashMap;
+    Clay_RenderCommandDiff renderCommandDiff;
+    Clay_BoundingBoxArray damageRectangles;
 };
 
+bool Clay__GrowElementArrays(Clay_Context *context);
+bool Clay__GrowArrayToFit(Clay_Context *context, int32_t *capacity, int32_t requiredCapacity);
+
 Clay_Context* Clay__Context_Allocate_Arena(Clay_Arena *arena) {
     size_t totalSizeBytes = sizeof(Clay_Context);
     if (totalSizeBytes > arena->capacity)
@@ -1327,20 +1903,51 @@ uint32_t Clay__GetParentElementId(void) {
 }
 
 Clay_LayoutConfig * Clay__StoreLayoutConfig(Clay_LayoutConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &CLAY_LAYOUT_DEFAULT : Clay__LayoutConfigArray_Add(&Clay_GetCurrentContext()->layoutConfigs, config); }
-Clay_TextElementConfig * Clay__StoreTextElementConfig(Clay_TextElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_TextElementConfig_DEFAULT : Clay__TextElementConfigArray_Add(&Clay_GetCurrentContext()->textElementConfigs, config); }
-Clay_AspectRatioElementConfig * Clay__StoreAspectRatioElementConfig(Clay_AspectRatioElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_AspectRatioElementConfig_DEFAULT : Clay__AspectRatioElementConfigArray_Add(&Clay_GetCurrentContext()->aspectRatioElementConfigs, config); }
-Clay_ImageElementConfig * Clay__StoreImageElementConfig(Clay_ImageElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_ImageElementConfig_DEFAULT : Clay__ImageElementConfigArray_Add(&Clay_GetCurrentContext()->imageElementConfigs, config); }
-Clay_FloatingElementConfig * Clay__StoreFloatingElementConfig(Clay_FloatingElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_FloatingElementConfig_DEFAULT : Clay__FloatingElementConfigArray_Add(&Clay_GetCurrentContext()->floatingElementConfigs, config); }
-Clay_CustomElementConfig * Clay__StoreCustomElementConfig(Clay_CustomElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_CustomElementConfig_DEFAULT : Clay__CustomElementConfigArray_Add(&Clay_GetCurrentContext()->customElementConfigs, config); }
-Clay_ClipElementConfig * Clay__StoreClipElementConfig(Clay_ClipElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_ClipElementConfig_DEFAULT : Clay__ClipElementConfigArray_Add(&Clay_GetCurrentContext()->clipElementConfigs, config); }
-Clay_BorderElementConfig * Clay__StoreBorderElementConfig(Clay_BorderElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_BorderElementConfig_DEFAULT : Clay__BorderElementConfigArray_Add(&Clay_GetCurrentContext()->borderElementConfigs, config); }
-Clay_SharedElementConfig * Clay__StoreSharedElementConfig(Clay_SharedElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_SharedElementConfig_DEFAULT : Clay__SharedElementConfigArray_Add(&Clay_GetCurrentContext()->sharedElementConfigs, config); }
+// Bump allocates space for an element config in the shared pool. Returns NULL if the pool is full, which ends the layout as if
+// the max element count had been exceeded.
+void *Clay__AllocateElementConfig(int32_t size) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
+        return CLAY__NULL;
+    }
+    Clay__charArray *pool = &context->elementConfigPool;
+    int32_t offset = (pool->length + CLAY__ELEMENT_CONFIG_ALIGNMENT - 1) & ~(CLAY__ELEMENT_CONFIG_ALIGNMENT - 1);
+    if (offset + size > pool->capacity && !Clay__GrowArrayToFit(context, &pool->capacity, offset + size)) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay ran out of space for element configs. Try using Clay_SetArrayCapacities() with a higher .elementConfigBytes."),
+            .userData = context->errorHandler.userData });
+        context->booleanWarnings.maxElementsExceeded = true;
+        return CLAY__NULL;
+    }
+    pool->length = offset + size;
+    return pool->internalArray + offset;
+}
+
+#define CLAY__STORE_ELEMENT_CONFIG(typeName, config) typeName *stored = (typeName *)Clay__AllocateElementConfig((int32_t)sizeof(typeName)); if (stored) { *stored = config; } return stored ? stored : &typeName##_DEFAULT;
+
+Clay_TextElementConfig * Clay__StoreTextElementConfig(Clay_TextElementConfig config) { CLAY__STORE_ELEMENT_CONFIG(Clay_TextElementConfig, config) }
+Clay_AspectRatioElementConfig * Clay__StoreAspectRatioElementConfig(Clay_AspectRatioElementConfig config) { CLAY__STORE_ELEMENT_CONFIG(Clay_AspectRatioElementConfig, config) }
+Clay_ImageElementConfig * Clay__StoreImageElementConfig(Clay_ImageElementConfig config) { CLAY__STORE_ELEMENT_CONFIG(Clay_ImageElementConfig, config) }
+Clay_FloatingElementConfig * Clay__StoreFloatingElementConfig(Clay_FloatingElementConfig config) { CLAY__STORE_ELEMENT_CONFIG(Clay_FloatingElementConfig, config) }
+Clay_CustomElementConfig * Clay__StoreCustomElementConfig(Clay_CustomElementConfig config) { CLAY__STORE_ELEMENT_CONFIG(Clay_CustomElementConfig, config) }
+Clay_ClipElementConfig * Clay__StoreClipElementConfig(Clay_ClipElementConfig config) { CLAY__STORE_ELEMENT_CONFIG(Clay_ClipElementConfig, config) }
+Clay_BorderElementConfig * Clay__StoreBorderElementConfig(Clay_BorderElementConfig config) { CLAY__STORE_ELEMENT_CONFIG(Clay_BorderElementConfig, config) }
+Clay_SharedElementConfig * Clay__StoreSharedElementConfig(Clay_SharedElementConfig config) { CLAY__STORE_ELEMENT_CONFIG(Clay_SharedElementConfig, config) }
 
 Clay_ElementConfig Clay__AttachElementConfig(Clay_ElementConfigUnion config, Clay__ElementConfigType type) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->booleanWarnings.maxElementsExceeded) {
         return CLAY__INIT(Clay_ElementConfig) CLAY__DEFAULT_STRUCT;
     }
+    if (context->elementConfigs.length == context->elementConfigs.capacity && !Clay__GrowArrayToFit(context, &context->elementConfigs.capacity, context->elementConfigs.length + 1)) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay ran out of capacity for attaching configs to elements. Try using Clay_SetArrayCapacities() with a higher .elementConfigs."),
+            .userData = context->errorHandler.userData });
+        context->booleanWarnings.maxElementsExceeded = true;
+        return CLAY__INIT(Clay_ElementConfig) CLAY__DEFAULT_STRUCT;
+    }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
     openLayoutElement->elementConfigs.length++;
     return *Clay__ElementConfigArray_Add(&context->elementConfigs, CLAY__INIT(Clay_ElementConfig) { .type = type, .config = config });
@@ -1557,6 +2164,16 @@ uint32_t Clay__HashStringContentsWithConfig(Clay_String *text, Clay_TextElementC
     return hash + 1; // Reserve the hash result of zero as "null id"
 }
 
+// Folds a value into the running hash of everything declared during the current layout, which is used to detect unchanged layouts
+uint64_t Clay__HashCombine(uint64_t hash, uint64_t value) {
+    hash = (hash ^ value) * 0x100000001b3ULL;
+    return hash ^ (hash >> 29);
+}
+
+void Clay__HashLayoutInput(Clay_Context *context, uint64_t value) {
+    context->layoutInputHash = Clay__HashCombine(context->layoutInputHash, value);
+}
+
 Clay__MeasuredWord *Clay__AddMeasuredWord(Clay__MeasuredWord word, Clay__MeasuredWord *previousWord) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->measuredWordsFreeList.length > 0) {
@@ -1571,10 +2188,162 @@ Clay__MeasuredWord *Clay__AddMeasuredWord(Clay__MeasuredWord word, Clay__Measure
     }
 }
 
+void Clay__FreeCachedWrappedLines(Clay__MeasureTextCacheItem *measured) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t lineIndex = measured->wrappedLinesStartIndex;
+    for (int32_t i = 0; i < measured->wrappedLineCount; ++i) {
+        Clay__int32_tArray_Add(&context->cachedWrappedLinesFreeList, lineIndex);
+        lineIndex = context->cachedWrappedLines.internalArray[lineIndex].next;
+    }
+    measured->wrappedLineCount = 0;
+}
+
+// Replaces the cached lines of the measured text with the lines it was just wrapped into at the given width.
+// If there isn't space for all of them, the text is left uncached and will be wrapped again next time.
+void Clay__CacheWrappedLines(Clay__MeasureTextCacheItem *measured, Clay__WrappedTextLineArraySlice lines, const char *textChars, float width) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__FreeCachedWrappedLines(measured);
+    if (lines.length > context->cachedWrappedLinesFreeList.length + context->cachedWrappedLines.capacity - context->cachedWrappedLines.length) {
+        return;
+    }
+    int32_t *previousNext = &measured->wrappedLinesStartIndex;
+    for (int32_t i = 0; i < lines.length; ++i) {
+        int32_t lineIndex;
+        if (context->cachedWrappedLinesFreeList.length > 0) {
+            lineIndex = context->cachedWrappedLinesFreeList.internalArray[--context->cachedWrappedLinesFreeList.length];
+        } else {
+            lineIndex = context->cachedWrappedLines.length++;
+        }
+        Clay__CachedWrappedLine *line = &context->cachedWrappedLines.internalArray[lineIndex];
+        *line = CLAY__INIT(Clay__CachedWrappedLine) { .startOffset = (int32_t)(lines.internalArray[i].line.chars - textChars), .length = lines.internalArray[i].line.length, .width = lines.internalArray[i].dimensions.width, .next = -1 };
+        *previousNext = lineIndex;
+        previousNext = &line->next;
+    }
+    measured->wrappedWidth = width;
+    measured->wrappedLineCount = lines.length;
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    uint32_t Clay__AtomicLoad(volatile uint32_t *value) { return (uint32_t)_InterlockedOr((volatile long *)value, 0); }
+    void Clay__AtomicStore(volatile uint32_t *value, uint32_t newValue) { _InterlockedExchange((volatile long *)value, (long)newValue); }
+    bool Clay__AtomicCompareExchange(volatile uint32_t *value, uint32_t expected, uint32_t desired) { return (uint32_t)_InterlockedCompareExchange((volatile long *)value, (long)desired, (long)expected) == expected; }
+#elif defined(__GNUC__) || defined(__clang__)
+    uint32_t Clay__AtomicLoad(volatile uint32_t *value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+    void Clay__AtomicStore(volatile uint32_t *value, uint32_t newValue) { __atomic_store_n(value, newValue, __ATOMIC_RELEASE); }
+    bool Clay__AtomicCompareExchange(volatile uint32_t *value, uint32_t expected, uint32_t desired) { return __atomic_compare_exchange_n(value, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); }
+#else
+    // Without atomics, a shared measure text cache is only safe to use from one thread at a time
+    uint32_t Clay__AtomicLoad(volatile uint32_t *value) { return *value; }
+    void Clay__AtomicStore(volatile uint32_t *value, uint32_t newValue) { *value = newValue; }
+    bool Clay__AtomicCompareExchange(volatile uint32_t *value, uint32_t expected, uint32_t desired) { if (*value != expected) { return false; } *value = desired; return true; }
+#endif
+
+#define CLAY__SHARED_MEASURE_TEXT_CACHE_MAX_PROBES 32
+
+// Returns the ready measurement of the text with this id, or NULL if it has to be measured by the calling context.
+// If the text isn't in the cache yet, claimedIndex is set to an item that the caller must publish with Clay__PublishSharedMeasurement.
+Clay__MeasureTextCacheItem *Clay__FindOrClaimSharedMeasurement(Clay_SharedMeasureTextCache *cache, uint32_t id, int32_t *claimedIndex) {
+    *claimedIndex = -1;
+    if (id == 0) {
+        return NULL;
+    }
+    uint32_t mask = (uint32_t)cache->itemCapacity - 1;
+    for (uint32_t probe = 0; probe < CLAY__SHARED_MEASURE_TEXT_CACHE_MAX_PROBES; ++probe) {
+        uint32_t itemIndex = (id + probe) & mask;
+        uint32_t itemId = Clay__AtomicLoad(&cache->itemIds[itemIndex]);
+        if (itemId == 0) {
+            if (Clay__AtomicCompareExchange(&cache->itemIds[itemIndex], 0, id)) {
+                *claimedIndex = (int32_t)itemIndex;
+                return NULL;
+            }
+            // Another context claimed this item first
+            itemId = Clay__AtomicLoad(&cache->itemIds[itemIndex]);
+        }
+        if (itemId == id) {
+            return Clay__AtomicLoad(&cache->itemStates[itemIndex]) == CLAY__SHARED_MEASUREMENT_STATE_READY ? &cache->items[itemIndex] : NULL;
+        }
+    }
+    // The cache is too full, the text will be measured by the context instead
+    return NULL;
+}
+
+// Returns the index of wordCount contiguous words allocated from the cache, or -1 if there isn't enough space left for them.
+// The count stops at maxWordCount rather than being added to unconditionally, so failed allocations can't overflow it.
+int32_t Clay__AllocateSharedMeasuredWords(Clay_SharedMeasureTextCache *cache, int32_t wordCount) {
+    uint32_t firstWordIndex = Clay__AtomicLoad(&cache->measuredWordCount);
+    while ((int64_t)firstWordIndex + wordCount <= cache->maxWordCount) {
+        if (Clay__AtomicCompareExchange(&cache->measuredWordCount, firstWordIndex, firstWordIndex + (uint32_t)wordCount)) {
+            return (int32_t)firstWordIndex;
+        }
+        // Another context allocated words first
+        firstWordIndex = Clay__AtomicLoad(&cache->measuredWordCount);
+    }
+    return -1;
+}
+
+// Copies a context's measurement into a claimed item, and makes it visible to every context using the cache
+void Clay__PublishSharedMeasurement(Clay_SharedMeasureTextCache *cache, int32_t itemIndex, Clay__MeasureTextCacheItem *measured) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t state = CLAY__SHARED_MEASUREMENT_STATE_FAILED;
+    if (measured != &Clay__MeasureTextCacheItem_DEFAULT && !measured->measurementPending) {
+        int32_t wordCount = 0;
+        for (int32_t wordIndex = measured->measuredWordsStartIndex; wordIndex != -1; wordIndex = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex)->next) {
+            wordCount++;
+        }
+        int32_t firstWordIndex = Clay__AllocateSharedMeasuredWords(cache, wordCount);
+        if (firstWordIndex != -1) {
+            // Words are stored contiguously, but still linked so that they are read the same way as a context's own words
+            int32_t sharedWordIndex = firstWordIndex;
+            for (int32_t wordIndex = measured->measuredWordsStartIndex; wordIndex != -1; ++sharedWordIndex) {
+                Clay__MeasuredWord *word = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
+                cache->measuredWords[sharedWordIndex] = *word;
+                cache->measuredWords[sharedWordIndex].next = word->next == -1 ? -1 : sharedWordIndex + 1;
+                wordIndex = word->next;
+            }
+            Clay__MeasureTextCacheItem *item = &cache->items[itemIndex];
+            *item = *measured;
+            item->measuredWordsStartIndex = wordCount > 0 ? firstWordIndex : -1;
+            item->inSharedCache = true;
+            item->nextIndex = 0;
+            item->generation = 0;
+            state = CLAY__SHARED_MEASUREMENT_STATE_READY;
+        }
+    }
+    Clay__AtomicStore(&cache->itemStates[itemIndex], state);
+}
+
+Clay__MeasuredWord *Clay__GetMeasuredWord(Clay__MeasureTextCacheItem *measured, int32_t wordIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (measured->inSharedCache) {
+        return &context->sharedMeasureTextCache->measuredWords[wordIndex];
+    }
+    return Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
+}
+
+#ifdef CLAY_PROFILE
+void Clay__ProfileBegin(Clay_ProfilePhase phase) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint64_t now = CLAY_PROFILE_TIMER();
+    context->profilePhaseStartTicks[phase] = now;
+    if (context->profileFrame.phases[phase].startTicks == 0) {
+        context->profileFrame.phases[phase].startTicks = now;
+    }
+}
+
+void Clay__ProfileEnd(Clay_ProfilePhase phase, int32_t count) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_ProfilePhaseStats *stats = &context->profileFrame.phases[phase];
+    stats->ticks += CLAY_PROFILE_TIMER() - context->profilePhaseStartTicks[phase];
+    stats->count += count;
+}
+#endif
+
+Clay__MeasureTextCacheItem *Clay__MeasureTextCachedInContext(Clay_String *text, Clay_TextElementConfig *config, uint32_t id);
+
 Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_TextElementConfig *config) {
     Clay_Context* context = Clay_GetCurrentContext();
     #ifndef CLAY_WASM
-    if (!Clay__MeasureText) {
+    if (!Clay__MeasureText && !context->measureTextBatchFunction) {
         if (!context->booleanWarnings.textMeasurementFunctionNotSet) {
             context->booleanWarnings.textMeasurementFunctionNotSet = true;
             context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
@@ -1586,6 +2355,156 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     }
     #endif
     uint32_t id = Clay__HashStringContentsWithConfig(text, config);
+    if (!context->sharedMeasureTextCache) {
+        return Clay__MeasureTextCachedInContext(text, config, id);
+    }
+    int32_t claimedIndex;
+    Clay__MeasureTextCacheItem *measured = Clay__FindOrClaimSharedMeasurement(context->sharedMeasureTextCache, id, &claimedIndex);
+    if (measured) {
+        return measured;
+    }
+    measured = Clay__MeasureTextCachedInContext(text, config, id);
+    if (claimedIndex != -1) {
+        Clay__PendingTextMeasurement *pending = context->pendingTextMeasurements.length > 0 ? Clay__PendingTextMeasurementArray_Get(&context->pendingTextMeasurements, context->pendingTextMeasurements.length - 1) : NULL;
+        if (measured->measurementPending && pending->cacheItemIndex == (int32_t)(measured - context->measureTextHashMapInternal.internalArray)) {
+            pending->sharedCacheItemIndex = claimedIndex; // Published once the batch has been measured
+        } else {
+            Clay__PublishSharedMeasurement(context->sharedMeasureTextCache, claimedIndex, measured);
+        }
+    }
+    return measured;
+}
+
+// Returns the next result of the batch while measuring pending text, otherwise calls the measure text function
+Clay_Dimensions Clay__MeasureTextSlice(Clay_StringSlice text, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->textMeasurementResultIndex >= 0) {
+        return *Clay__DimensionsArray_Get(&context->textMeasurementResults, context->textMeasurementResultIndex++);
+    }
+    #ifndef CLAY_WASM
+    if (!Clay__MeasureText) {
+        // Only a batch function was provided, so it's called with a single request
+        Clay_Dimensions dimensions = CLAY__DEFAULT_STRUCT;
+        Clay_TextMeasurementRequest request = { .text = text, .config = config };
+        CLAY_PROFILE_BEGIN(CLAY_PROFILE_PHASE_MEASURE_TEXT);
+        context->measureTextBatchFunction(&request, &dimensions, 1, context->measureTextBatchUserData);
+        CLAY_PROFILE_END(CLAY_PROFILE_PHASE_MEASURE_TEXT, 1);
+        return dimensions;
+    }
+    #endif
+    CLAY_PROFILE_BEGIN(CLAY_PROFILE_PHASE_MEASURE_TEXT);
+    Clay_Dimensions dimensions = Clay__MeasureText(text, config, context->measureTextUserData);
+    CLAY_PROFILE_END(CLAY_PROFILE_PHASE_MEASURE_TEXT, 1);
+    return dimensions;
+}
+
+void Clay__ReportTextMeasurementCapacityExceeded(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay has run out of space in it's internal text measurement cache. Try using Clay_SetMaxMeasureTextCacheWordCount() (default 16384, with 1 unit storing 1 measured word)."),
+            .userData = context->errorHandler.userData });
+        context->booleanWarnings.maxTextMeasureCacheExceeded = true;
+    }
+}
+
+// Returns the metrics of the font configuration, adding unmeasured metrics if they haven't been seen before.
+// Returns NULL if there isn't space for them, in which case they are measured every time they're needed.
+Clay__FontMetrics *Clay__FindOrAddFontMetrics(Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < context->fontMetrics.length; ++i) {
+        Clay__FontMetrics *metrics = Clay__FontMetricsArray_Get(&context->fontMetrics, i);
+        if (metrics->fontId == config->fontId && metrics->fontSize == config->fontSize && metrics->letterSpacing == config->letterSpacing) {
+            return metrics;
+        }
+    }
+    if (context->fontMetrics.length == context->fontMetrics.capacity) {
+        return NULL;
+    }
+    return Clay__FontMetricsArray_Add(&context->fontMetrics, CLAY__INIT(Clay__FontMetrics) { .fontId = config->fontId, .fontSize = config->fontSize, .letterSpacing = config->letterSpacing });
+}
+
+float Clay__GetSpaceWidth(Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__FontMetrics *metrics = Clay__FindOrAddFontMetrics(config);
+    if (metrics && metrics->measured) {
+        context->fontMetricsCacheStats.hitCount++;
+        return metrics->spaceDimensions.width;
+    }
+    context->fontMetricsCacheStats.missCount++;
+    Clay_Dimensions spaceDimensions = Clay__MeasureTextSlice(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config);
+    if (metrics) {
+        metrics->spaceDimensions = spaceDimensions;
+        metrics->measured = true;
+        metrics->measurementRequested = false;
+    }
+    return spaceDimensions.width;
+}
+
+// Splits text into words, measures them and stores them in the context's measured words. Returns false if there wasn't enough space.
+bool Clay__MeasureTextWords(Clay__MeasureTextCacheItem *measured, Clay_String *text, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t start = 0;
+    int32_t end = 0;
+    float lineWidth = 0;
+    float measuredWidth = 0;
+    float measuredHeight = 0;
+    float spaceWidth = Clay__GetSpaceWidth(config);
+    Clay__MeasuredWord tempWord = { .next = -1 };
+    Clay__MeasuredWord *previousWord = &tempWord;
+    while (end < text->length) {
+        if (context->measuredWords.length == context->measuredWords.capacity - 1) {
+            Clay__ReportTextMeasurementCapacityExceeded();
+            return false;
+        }
+        char current = text->chars[end];
+        if (current == ' ' || current == '\n') {
+            int32_t length = end - start;
+            Clay_Dimensions dimensions = CLAY__DEFAULT_STRUCT;
+            if (length > 0) {
+                dimensions = Clay__MeasureTextSlice(CLAY__INIT(Clay_StringSlice) {.length = length, .chars = &text->chars[start], .baseChars = text->chars}, config);
+            }
+            measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
+            measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
+            if (current == ' ') {
+                dimensions.width += spaceWidth;
+                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length + 1, .width = dimensions.width, .next = -1 }, previousWord);
+                lineWidth += dimensions.width;
+            }
+            if (current == '\n') {
+                if (length > 0) {
+                    previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length, .width = dimensions.width, .next = -1 }, previousWord);
+                }
+                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = end + 1, .length = 0, .width = 0, .next = -1 }, previousWord);
+                lineWidth += dimensions.width;
+                measuredWidth = CLAY__MAX(lineWidth, measuredWidth);
+                measured->containsNewlines = true;
+                lineWidth = 0;
+            }
+            start = end + 1;
+        }
+        end++;
+    }
+    if (end - start > 0) {
+        Clay_Dimensions dimensions = Clay__MeasureTextSlice(CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config);
+        Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start, .width = dimensions.width, .next = -1 }, previousWord);
+        lineWidth += dimensions.width;
+        measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
+        measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
+    }
+    measuredWidth = CLAY__MAX(lineWidth, measuredWidth) - config->letterSpacing;
+
+    measured->measuredWordsStartIndex = tempWord.next;
+    measured->unwrappedDimensions.width = measuredWidth;
+    measured->unwrappedDimensions.height = measuredHeight;
+    measured->spaceWidth = spaceWidth;
+    return true;
+}
+
+// Measures text using the context's own cache, which evicts measurements that haven't been used for a few frames
+Clay__MeasureTextCacheItem *Clay__MeasureTextCachedInContext(Clay_String *text, Clay_TextElementConfig *config, uint32_t id) {
+    Clay_Context* context = Clay_GetCurrentContext();
     uint32_t hashBucket = id % (context->maxMeasureTextCacheWordCount / 32);
     int32_t elementIndexPrevious = 0;
     int32_t elementIndex = context->measureTextHashMap.internalArray[hashBucket];
@@ -1604,6 +2523,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
                 Clay__int32_tArray_Add(&context->measuredWordsFreeList, nextWordIndex);
                 nextWordIndex = measuredWord->next;
             }
+            Clay__FreeCachedWrappedLines(hashEntry);
 
             int32_t nextIndex = hashEntry->nextIndex;
             Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, elementIndex, CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1 });
@@ -1630,7 +2550,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, newItemIndex, newCacheItem);
         measured = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, newItemIndex);
     } else {
-        if (context->measureTextHashMapInternal.length == context->measureTextHashMapInternal.capacity - 1) {
+        if (context->measureTextHashMapInternal.length == context->measureTextHashMapInternal.capacity - 1 && !Clay__GrowElementArrays(context)) {
             if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
                 context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                         .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
@@ -1644,65 +2564,13 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         newItemIndex = context->measureTextHashMapInternal.length - 1;
     }
 
-    int32_t start = 0;
-    int32_t end = 0;
-    float lineWidth = 0;
-    float measuredWidth = 0;
-    float measuredHeight = 0;
-    float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config, context->measureTextUserData).width;
-    Clay__MeasuredWord tempWord = { .next = -1 };
-    Clay__MeasuredWord *previousWord = &tempWord;
-    while (end < text->length) {
-        if (context->measuredWords.length == context->measuredWords.capacity - 1) {
-            if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
-                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-                    .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
-                    .errorText = CLAY_STRING("Clay has run out of space in it's internal text measurement cache. Try using Clay_SetMaxMeasureTextCacheWordCount() (default 16384, with 1 unit storing 1 measured word)."),
-                    .userData = context->errorHandler.userData });
-                context->booleanWarnings.maxTextMeasureCacheExceeded = true;
-            }
-            return &Clay__MeasureTextCacheItem_DEFAULT;
-        }
-        char current = text->chars[end];
-        if (current == ' ' || current == '\n') {
-            int32_t length = end - start;
-            Clay_Dimensions dimensions = CLAY__DEFAULT_STRUCT;
-            if (length > 0) {
-                dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) {.length = length, .chars = &text->chars[start], .baseChars = text->chars}, config, context->measureTextUserData);
-            }
-            measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
-            measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
-            if (current == ' ') {
-                dimensions.width += spaceWidth;
-                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length + 1, .width = dimensions.width, .next = -1 }, previousWord);
-                lineWidth += dimensions.width;
-            }
-            if (current == '\n') {
-                if (length > 0) {
-                    previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length, .width = dimensions.width, .next = -1 }, previousWord);
-                }
-                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = end + 1, .length = 0, .width = 0, .next = -1 }, previousWord);
-                lineWidth += dimensions.width;
-                measuredWidth = CLAY__MAX(lineWidth, measuredWidth);
-                measured->containsNewlines = true;
-                lineWidth = 0;
-            }
-            start = end + 1;
-        }
-        end++;
-    }
-    if (end - start > 0) {
-        Clay_Dimensions dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config, context->measureTextUserData);
-        Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start, .width = dimensions.width, .next = -1 }, previousWord);
-        lineWidth += dimensions.width;
-        measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
-        measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
+    if (context->measureTextBatchFunction && !context->textMeasurementBatchingPaused) {
+        // Measured along with all other new text once the layout has been declared
+        measured->measurementPending = true;
+        Clay__PendingTextMeasurementArray_Add(&context->pendingTextMeasurements, CLAY__INIT(Clay__PendingTextMeasurement) { .text = *text, .config = config, .cacheItemIndex = newItemIndex, .sharedCacheItemIndex = -1 });
+    } else if (!Clay__MeasureTextWords(measured, text, config)) {
+        return &Clay__MeasureTextCacheItem_DEFAULT;
     }
-    measuredWidth = CLAY__MAX(lineWidth, measuredWidth) - config->letterSpacing;
-
-    measured->measuredWordsStartIndex = tempWord.next;
-    measured->unwrappedDimensions.width = measuredWidth;
-    measured->unwrappedDimensions.height = measuredHeight;
 
     if (elementIndexPrevious != 0) {
         Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndexPrevious)->nextIndex = newItemIndex;
@@ -1716,62 +2584,166 @@ bool Clay__PointIsInsideRect(Clay_Vector2 point, Clay_BoundingBox rect) {
     return point.x >= rect.x && point.x <= rect.x + rect.width && point.y >= rect.y && point.y <= rect.y + rect.height;
 }
 
-Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Clay_LayoutElement* layoutElement) {
+// Returns the overlap of two boxes, which has zero width or height if they don't overlap
+Clay_BoundingBox Clay__IntersectBoundingBoxes(Clay_BoundingBox a, Clay_BoundingBox b) {
+    float x = CLAY__MAX(a.x, b.x);
+    float y = CLAY__MAX(a.y, b.y);
+    return CLAY__INIT(Clay_BoundingBox) { x, y, CLAY__MAX(CLAY__MIN(a.x + a.width, b.x + b.width) - x, 0), CLAY__MAX(CLAY__MIN(a.y + a.height, b.y + b.height) - y, 0) };
+}
+
+Clay_BoundingBox Clay__UnionBoundingBoxes(Clay_BoundingBox a, Clay_BoundingBox b) {
+    float x = CLAY__MIN(a.x, b.x);
+    float y = CLAY__MIN(a.y, b.y);
+    return CLAY__INIT(Clay_BoundingBox) { x, y, CLAY__MAX(a.x + a.width, b.x + b.width) - x, CLAY__MAX(a.y + a.height, b.y + b.height) - y };
+}
+
+// Returns a bit mask with bit i set for each tag in the group that is equal to the provided tag
+#if !defined(CLAY_DISABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64))
+uint32_t Clay__HashMapGroupMatchTag(const Clay__LayoutElementHashMapGroup *group, uint8_t tag) {
+    __m128i tags = _mm_loadu_si128((const __m128i *)group->tags);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(tags, _mm_set1_epi8((char)tag)));
+}
+#elif !defined(CLAY_DISABLE_SIMD) && defined(__aarch64__)
+uint32_t Clay__HashMapGroupMatchTag(const Clay__LayoutElementHashMapGroup *group, uint8_t tag) {
+    static const uint8_t bitWeights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t matches = vandq_u8(vceqq_u8(vld1q_u8(group->tags), vdupq_n_u8(tag)), vld1q_u8(bitWeights));
+    return (uint32_t)vaddv_u8(vget_low_u8(matches)) | ((uint32_t)vaddv_u8(vget_high_u8(matches)) << 8);
+}
+#else
+// Compares eight tags at a time in a 64 bit word, then gathers the high bit of each matching byte into the low byte
+uint32_t Clay__HashMapGroupMatchTagWord(const uint8_t *tags, uint8_t tag) {
+    // Assembled byte by byte so that tag i always lands in byte i regardless of endianness, compilers turn this into a single load
+    uint64_t word = (uint64_t)tags[0] | (uint64_t)tags[1] << 8 | (uint64_t)tags[2] << 16 | (uint64_t)tags[3] << 24
+        | (uint64_t)tags[4] << 32 | (uint64_t)tags[5] << 40 | (uint64_t)tags[6] << 48 | (uint64_t)tags[7] << 56;
+    uint64_t difference = word ^ (0x0101010101010101ull * tag);
+    uint64_t zeroBytes = ~(((difference & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | difference) & 0x8080808080808080ull;
+    return (uint32_t)(((zeroBytes >> 7) * 0x0102040810204080ull) >> 56);
+}
+
+uint32_t Clay__HashMapGroupMatchTag(const Clay__LayoutElementHashMapGroup *group, uint8_t tag) {
+    return Clay__HashMapGroupMatchTagWord(group->tags, tag) | (Clay__HashMapGroupMatchTagWord(group->tags + 8, tag) << 8);
+}
+#endif
+
+int32_t Clay__CountTrailingZeros(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(value);
+#else
+    int32_t count = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+uint8_t Clay__HashMapTag(uint32_t hash) {
+    return (uint8_t)(0x80 | (hash >> 25)); // The high bit is always set so that a zero tag marks an empty slot
+}
+
+// Returns the index of the item with this id, or -1 if it isn't in the map
+int32_t Clay__HashMapFindItemIndex(uint32_t id) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1) {
-        return NULL;
+    uint32_t hash = id * 0x9E3779B1u;
+    uint8_t tag = Clay__HashMapTag(hash);
+    uint32_t groupMask = (uint32_t)context->layoutElementsHashMap.capacity - 1;
+    uint32_t groupIndex = (hash ^ (hash >> 15)) & groupMask;
+    // Triangular probing visits every group when the group count is a power of two
+    for (uint32_t probe = 1; probe <= groupMask + 1; ++probe) {
+        Clay__LayoutElementHashMapGroup *group = &context->layoutElementsHashMap.internalArray[groupIndex];
+        uint32_t matches = Clay__HashMapGroupMatchTag(group, tag);
+        while (matches != 0) {
+            int32_t itemIndex = group->itemIndexes[Clay__CountTrailingZeros(matches)];
+            if (context->layoutElementsHashMapInternal.internalArray[itemIndex].id == id) {
+                return itemIndex;
+            }
+            matches &= matches - 1;
+        }
+        // Items are never removed, so a group with an empty slot ends the probe sequence
+        if (Clay__HashMapGroupMatchTag(group, 0) != 0) {
+            return -1;
+        }
+        groupIndex = (groupIndex + probe) & groupMask;
     }
-    Clay_LayoutElementHashMapItem item = { .elementId = elementId, .layoutElement = layoutElement, .nextIndex = -1, .generation = context->generation + 1 };
-    uint32_t hashBucket = elementId.id % context->layoutElementsHashMap.capacity;
-    int32_t hashItemPrevious = -1;
-    int32_t hashItemIndex = context->layoutElementsHashMap.internalArray[hashBucket];
-    while (hashItemIndex != -1) { // Just replace collision, not a big deal - leave it up to the end user
-        Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, hashItemIndex);
-        if (hashItem->elementId.id == elementId.id) { // Collision - resolve based on generation
-            item.nextIndex = hashItem->nextIndex;
-            if (hashItem->generation <= context->generation) { // First collision - assume this is the "same" element
-                hashItem->elementId = elementId; // Make sure to copy this across. If the stringId reference has changed, we should update the hash item to use the new one.
-                hashItem->generation = context->generation + 1;
-                hashItem->layoutElement = layoutElement;
-                hashItem->debugData->collision = false;
-                hashItem->onHoverFunction = NULL;
-                hashItem->hoverFunctionUserData = 0;
-            } else { // Multiple collisions this frame - two elements have the same ID
-                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-                    .errorType = CLAY_ERROR_TYPE_DUPLICATE_ID,
-                    .errorText = CLAY_STRING("An element with this ID was already previously declared during this layout."),
-                    .userData = context->errorHandler.userData });
-                if (context->debugModeEnabled) {
-                    hashItem->debugData->collision = true;
-                }
+    return -1;
+}
+
+// Stores an item index for an id that isn't in the map yet, in the first empty slot of its probe sequence
+bool Clay__HashMapInsertItemIndex(uint32_t id, int32_t itemIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t hash = id * 0x9E3779B1u;
+    uint32_t groupMask = (uint32_t)context->layoutElementsHashMap.capacity - 1;
+    uint32_t groupIndex = (hash ^ (hash >> 15)) & groupMask;
+    for (uint32_t probe = 1; probe <= groupMask + 1; ++probe) {
+        Clay__LayoutElementHashMapGroup *group = &context->layoutElementsHashMap.internalArray[groupIndex];
+        uint32_t empty = Clay__HashMapGroupMatchTag(group, 0);
+        if (empty != 0) {
+            int32_t slot = Clay__CountTrailingZeros(empty);
+            group->tags[slot] = Clay__HashMapTag(hash);
+            group->itemIndexes[slot] = itemIndex;
+            return true;
+        }
+        groupIndex = (groupIndex + probe) & groupMask;
+    }
+    return false;
+}
+
+Clay__LayoutElementHashMapItemColdData *Clay__GetHashMapItemColdData(Clay_LayoutElementHashMapItem *item) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (item == &Clay_LayoutElementHashMapItem_DEFAULT) {
+        return &Clay__LayoutElementHashMapItemColdData_DEFAULT;
+    }
+    return &context->layoutElementsHashMapColdData.internalArray[item - context->layoutElementsHashMapInternal.internalArray];
+}
+
+Clay__DebugElementData *Clay__GetHashMapItemDebugData(Clay_LayoutElementHashMapItem *item) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (item == &Clay_LayoutElementHashMapItem_DEFAULT) {
+        return &Clay__DebugElementData_DEFAULT;
+    }
+    return &context->debugElementData.internalArray[item - context->layoutElementsHashMapInternal.internalArray];
+}
+
+Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Clay_LayoutElement* layoutElement) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t itemIndex = Clay__HashMapFindItemIndex(elementId.id);
+    if (itemIndex != -1) { // Collision - resolve based on generation
+        Clay_LayoutElementHashMapItem *hashItem = &context->layoutElementsHashMapInternal.internalArray[itemIndex];
+        Clay__LayoutElementHashMapItemColdData *coldData = &context->layoutElementsHashMapColdData.internalArray[itemIndex];
+        if (hashItem->generation <= context->generation) { // First collision - assume this is the "same" element
+            coldData->elementId = elementId; // Make sure to copy this across. If the stringId reference has changed, we should update the hash item to use the new one.
+            hashItem->generation = context->generation + 1;
+            hashItem->layoutElement = layoutElement;
+            context->debugElementData.internalArray[itemIndex].collision = false;
+            coldData->onHoverFunction = NULL;
+            coldData->hoverFunctionUserData = 0;
+        } else { // Multiple collisions this frame - two elements have the same ID
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_DUPLICATE_ID,
+                .errorText = CLAY_STRING("An element with this ID was already previously declared during this layout."),
+                .userData = context->errorHandler.userData });
+            if (context->debugModeEnabled) {
+                context->debugElementData.internalArray[itemIndex].collision = true;
             }
-            return hashItem;
         }
-        hashItemPrevious = hashItemIndex;
-        hashItemIndex = hashItem->nextIndex;
+        return hashItem;
     }
-    Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Add(&context->layoutElementsHashMapInternal, item);
-    hashItem->debugData = Clay__DebugElementDataArray_Add(&context->debugElementData, CLAY__INIT(Clay__DebugElementData) CLAY__DEFAULT_STRUCT);
-    if (hashItemPrevious != -1) {
-        Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, hashItemPrevious)->nextIndex = (int32_t)context->layoutElementsHashMapInternal.length - 1;
-    } else {
-        context->layoutElementsHashMap.internalArray[hashBucket] = (int32_t)context->layoutElementsHashMapInternal.length - 1;
+    if ((context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1 && !Clay__GrowElementArrays(context)) || !Clay__HashMapInsertItemIndex(elementId.id, context->layoutElementsHashMapInternal.length)) {
+        return NULL;
     }
-    return hashItem;
+    Clay__LayoutElementHashMapItemColdDataArray_Add(&context->layoutElementsHashMapColdData, CLAY__INIT(Clay__LayoutElementHashMapItemColdData) { .elementId = elementId });
+    Clay__DebugElementDataArray_Add(&context->debugElementData, CLAY__INIT(Clay__DebugElementData) CLAY__DEFAULT_STRUCT);
+    return Clay__LayoutElementHashMapItemArray_Add(&context->layoutElementsHashMapInternal, CLAY__INIT(Clay_LayoutElementHashMapItem) { .layoutElement = layoutElement, .id = elementId.id, .generation = context->generation + 1 });
 }
 
 Clay_LayoutElementHashMapItem *Clay__GetHashMapItem(uint32_t id) {
     Clay_Context* context = Clay_GetCurrentContext();
-    uint32_t hashBucket = id % context->layoutElementsHashMap.capacity;
-    int32_t elementIndex = context->layoutElementsHashMap.internalArray[hashBucket];
-    while (elementIndex != -1) {
-        Clay_LayoutElementHashMapItem *hashEntry = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, elementIndex);
-        if (hashEntry->elementId.id == id) {
-            return hashEntry;
-        }
-        elementIndex = hashEntry->nextIndex;
+    int32_t itemIndex = Clay__HashMapFindItemIndex(id);
+    if (itemIndex == -1) {
+        return &Clay_LayoutElementHashMapItem_DEFAULT;
     }
-    return &Clay_LayoutElementHashMapItem_DEFAULT;
+    return &context->layoutElementsHashMapInternal.internalArray[itemIndex];
 }
 
 Clay_ElementId Clay__GenerateIdForAnonymousElement(Clay_LayoutElement *openLayoutElement) {
@@ -1812,94 +2784,72 @@ void Clay__UpdateAspectRatioBox(Clay_LayoutElement *layoutElement) {
     }
 }
 
-void Clay__CloseElement(void) {
+// Sizes an element to fit its attached children, clamped to the min and max sizes of its layout config.
+// Called when the element is closed, and again if text was measured after the layout was declared.
+void Clay__CalculateFitDimensions(Clay_LayoutElement *layoutElement) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->booleanWarnings.maxElementsExceeded) {
-        return;
-    }
-    Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
-    Clay_LayoutConfig *layoutConfig = openLayoutElement->layoutConfig;
-    if (!layoutConfig) {
-        openLayoutElement->layoutConfig = &Clay_LayoutConfig_DEFAULT;
-        layoutConfig = &Clay_LayoutConfig_DEFAULT;
-    }
-    bool elementHasClipHorizontal = false;
-    bool elementHasClipVertical = false;
-    for (int32_t i = 0; i < openLayoutElement->elementConfigs.length; i++) {
-        Clay_ElementConfig *config = Clay__ElementConfigArraySlice_Get(&openLayoutElement->elementConfigs, i);
-        if (config->type == CLAY__ELEMENT_CONFIG_TYPE_CLIP) {
-            elementHasClipHorizontal = config->config.clipElementConfig->horizontal;
-            elementHasClipVertical = config->config.clipElementConfig->vertical;
-            context->openClipElementStack.length--;
-            break;
-        } else if (config->type == CLAY__ELEMENT_CONFIG_TYPE_FLOATING) {
-            context->openClipElementStack.length--;
-        }
-    }
+    Clay_LayoutConfig *layoutConfig = layoutElement->layoutConfig;
+    Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(layoutElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+    bool elementHasClipHorizontal = clipConfig && clipConfig->horizontal;
+    bool elementHasClipVertical = clipConfig && clipConfig->vertical;
 
     float leftRightPadding = (float)(layoutConfig->padding.left + layoutConfig->padding.right);
     float topBottomPadding = (float)(layoutConfig->padding.top + layoutConfig->padding.bottom);
 
-    // Attach children to the current open element
-    openLayoutElement->childrenOrTextContent.children.elements = &context->layoutElementChildren.internalArray[context->layoutElementChildren.length];
+    layoutElement->dimensions = CLAY__INIT(Clay_Dimensions) CLAY__DEFAULT_STRUCT;
+    layoutElement->minDimensions = CLAY__INIT(Clay_Dimensions) CLAY__DEFAULT_STRUCT;
     if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-        openLayoutElement->dimensions.width = leftRightPadding;
-        openLayoutElement->minDimensions.width = leftRightPadding;
-        for (int32_t i = 0; i < openLayoutElement->childrenOrTextContent.children.length; i++) {
-            int32_t childIndex = Clay__int32_tArray_GetValue(&context->layoutElementChildrenBuffer, (int)context->layoutElementChildrenBuffer.length - openLayoutElement->childrenOrTextContent.children.length + i);
-            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, childIndex);
-            openLayoutElement->dimensions.width += child->dimensions.width;
-            openLayoutElement->dimensions.height = CLAY__MAX(openLayoutElement->dimensions.height, child->dimensions.height + topBottomPadding);
+        layoutElement->dimensions.width = leftRightPadding;
+        layoutElement->minDimensions.width = leftRightPadding;
+        for (int32_t i = 0; i < layoutElement->childrenOrTextContent.children.length; i++) {
+            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, layoutElement->childrenOrTextContent.children.elements[i]);
+            layoutElement->dimensions.width += child->dimensions.width;
+            layoutElement->dimensions.height = CLAY__MAX(layoutElement->dimensions.height, child->dimensions.height + topBottomPadding);
             // Minimum size of child elements doesn't matter to clip containers as they can shrink and hide their contents
             if (!elementHasClipHorizontal) {
-                openLayoutElement->minDimensions.width += child->minDimensions.width;
+                layoutElement->minDimensions.width += child->minDimensions.width;
             }
             if (!elementHasClipVertical) {
-                openLayoutElement->minDimensions.height = CLAY__MAX(openLayoutElement->minDimensions.height, child->minDimensions.height + topBottomPadding);
+                layoutElement->minDimensions.height = CLAY__MAX(layoutElement->minDimensions.height, child->minDimensions.height + topBottomPadding);
             }
-            Clay__int32_tArray_Add(&context->layoutElementChildren, childIndex);
         }
-        float childGap = (float)(CLAY__MAX(openLayoutElement->childrenOrTextContent.children.length - 1, 0) * layoutConfig->childGap);
-        openLayoutElement->dimensions.width += childGap;
+        float childGap = (float)(CLAY__MAX(layoutElement->childrenOrTextContent.children.length - 1, 0) * layoutConfig->childGap);
+        layoutElement->dimensions.width += childGap;
         if (!elementHasClipHorizontal) {
-            openLayoutElement->minDimensions.width += childGap;
+            layoutElement->minDimensions.width += childGap;
         }
     }
     else if (layoutConfig->layoutDirection == CLAY_TOP_TO_BOTTOM) {
-        openLayoutElement->dimensions.height = topBottomPadding;
-        openLayoutElement->minDimensions.height = topBottomPadding;
-        for (int32_t i = 0; i < openLayoutElement->childrenOrTextContent.children.length; i++) {
-            int32_t childIndex = Clay__int32_tArray_GetValue(&context->layoutElementChildrenBuffer, (int)context->layoutElementChildrenBuffer.length - openLayoutElement->childrenOrTextContent.children.length + i);
-            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, childIndex);
-            openLayoutElement->dimensions.height += child->dimensions.height;
-            openLayoutElement->dimensions.width = CLAY__MAX(openLayoutElement->dimensions.width, child->dimensions.width + leftRightPadding);
+        layoutElement->dimensions.height = topBottomPadding;
+        layoutElement->minDimensions.height = topBottomPadding;
+        for (int32_t i = 0; i < layoutElement->childrenOrTextContent.children.length; i++) {
+            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, layoutElement->childrenOrTextContent.children.elements[i]);
+            layoutElement->dimensions.height += child->dimensions.height;
+            layoutElement->dimensions.width = CLAY__MAX(layoutElement->dimensions.width, child->dimensions.width + leftRightPadding);
             // Minimum size of child elements doesn't matter to clip containers as they can shrink and hide their contents
             if (!elementHasClipVertical) {
-                openLayoutElement->minDimensions.height += child->minDimensions.height;
+                layoutElement->minDimensions.height += child->minDimensions.height;
             }
             if (!elementHasClipHorizontal) {
-                openLayoutElement->minDimensions.width = CLAY__MAX(openLayoutElement->minDimensions.width, child->minDimensions.width + leftRightPadding);
+                layoutElement->minDimensions.width = CLAY__MAX(layoutElement->minDimensions.width, child->minDimensions.width + leftRightPadding);
             }
-            Clay__int32_tArray_Add(&context->layoutElementChildren, childIndex);
         }
-        float childGap = (float)(CLAY__MAX(openLayoutElement->childrenOrTextContent.children.length - 1, 0) * layoutConfig->childGap);
-        openLayoutElement->dimensions.height += childGap;
+        float childGap = (float)(CLAY__MAX(layoutElement->childrenOrTextContent.children.length - 1, 0) * layoutConfig->childGap);
+        layoutElement->dimensions.height += childGap;
         if (!elementHasClipVertical) {
-            openLayoutElement->minDimensions.height += childGap;
+            layoutElement->minDimensions.height += childGap;
         }
     }
 
-    context->layoutElementChildrenBuffer.length -= openLayoutElement->childrenOrTextContent.children.length;
-
     // Clamp element min and max width to the values configured in the layout
     if (layoutConfig->sizing.width.type != CLAY__SIZING_TYPE_PERCENT) {
         if (layoutConfig->sizing.width.size.minMax.max <= 0) { // Set the max size if the user didn't specify, makes calculations easier
             layoutConfig->sizing.width.size.minMax.max = CLAY__MAXFLOAT;
         }
-        openLayoutElement->dimensions.width = CLAY__MIN(CLAY__MAX(openLayoutElement->dimensions.width, layoutConfig->sizing.width.size.minMax.min), layoutConfig->sizing.width.size.minMax.max);
-        openLayoutElement->minDimensions.width = CLAY__MIN(CLAY__MAX(openLayoutElement->minDimensions.width, layoutConfig->sizing.width.size.minMax.min), layoutConfig->sizing.width.size.minMax.max);
+        layoutElement->dimensions.width = CLAY__MIN(CLAY__MAX(layoutElement->dimensions.width, layoutConfig->sizing.width.size.minMax.min), layoutConfig->sizing.width.size.minMax.max);
+        layoutElement->minDimensions.width = CLAY__MIN(CLAY__MAX(layoutElement->minDimensions.width, layoutConfig->sizing.width.size.minMax.min), layoutConfig->sizing.width.size.minMax.max);
     } else {
-        openLayoutElement->dimensions.width = 0;
+        layoutElement->dimensions.width = 0;
     }
 
     // Clamp element min and max height to the values configured in the layout
@@ -1907,13 +2857,44 @@ void Clay__CloseElement(void) {
         if (layoutConfig->sizing.height.size.minMax.max <= 0) { // Set the max size if the user didn't specify, makes calculations easier
             layoutConfig->sizing.height.size.minMax.max = CLAY__MAXFLOAT;
         }
-        openLayoutElement->dimensions.height = CLAY__MIN(CLAY__MAX(openLayoutElement->dimensions.height, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
-        openLayoutElement->minDimensions.height = CLAY__MIN(CLAY__MAX(openLayoutElement->minDimensions.height, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
+        layoutElement->dimensions.height = CLAY__MIN(CLAY__MAX(layoutElement->dimensions.height, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
+        layoutElement->minDimensions.height = CLAY__MIN(CLAY__MAX(layoutElement->minDimensions.height, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
     } else {
-        openLayoutElement->dimensions.height = 0;
+        layoutElement->dimensions.height = 0;
     }
 
-    Clay__UpdateAspectRatioBox(openLayoutElement);
+    Clay__UpdateAspectRatioBox(layoutElement);
+}
+
+void Clay__CloseElement(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
+        return;
+    }
+    Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
+    if (context->layoutCachingEnabled) {
+        Clay__HashLayoutInput(context, ~(uint64_t)openLayoutElement->id); // Closing is hashed too, so that changes in nesting are detected
+    }
+    if (!openLayoutElement->layoutConfig) {
+        openLayoutElement->layoutConfig = &Clay_LayoutConfig_DEFAULT;
+    }
+    for (int32_t i = 0; i < openLayoutElement->elementConfigs.length; i++) {
+        Clay_ElementConfig *config = Clay__ElementConfigArraySlice_Get(&openLayoutElement->elementConfigs, i);
+        if (config->type == CLAY__ELEMENT_CONFIG_TYPE_CLIP) {
+            context->openClipElementStack.length--;
+            break;
+        } else if (config->type == CLAY__ELEMENT_CONFIG_TYPE_FLOATING) {
+            context->openClipElementStack.length--;
+        }
+    }
+
+    // Attach children to the current open element
+    openLayoutElement->childrenOrTextContent.children.elements = &context->layoutElementChildren.internalArray[context->layoutElementChildren.length];
+    for (int32_t i = 0; i < openLayoutElement->childrenOrTextContent.children.length; i++) {
+        Clay__int32_tArray_Add(&context->layoutElementChildren, Clay__int32_tArray_GetValue(&context->layoutElementChildrenBuffer, (int)context->layoutElementChildrenBuffer.length - openLayoutElement->childrenOrTextContent.children.length + i));
+    }
+    context->layoutElementChildrenBuffer.length -= openLayoutElement->childrenOrTextContent.children.length;
+    Clay__CalculateFitDimensions(openLayoutElement);
 
     bool elementIsFloating = Clay__ElementHasConfig(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING);
 
@@ -2000,7 +2981,7 @@ bool Clay__MemCmp(const char *s1, const char *s2, int32_t length);
 
 void Clay__OpenElement(void) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
+    if ((context->layoutElements.length == context->layoutElements.capacity - 1 && !Clay__GrowElementArrays(context)) || context->booleanWarnings.maxElementsExceeded) {
         context->booleanWarnings.maxElementsExceeded = true;
         return;
     }
@@ -2008,6 +2989,9 @@ void Clay__OpenElement(void) {
     Clay_LayoutElement* openLayoutElement = Clay_LayoutElementArray_Add(&context->layoutElements, layoutElement);
     Clay__int32_tArray_Add(&context->openLayoutElementStack, context->layoutElements.length - 1);
     Clay__GenerateIdForAnonymousElement(openLayoutElement);
+    if (context->layoutCachingEnabled) {
+        Clay__HashLayoutInput(context, openLayoutElement->id);
+    }
     if (context->openClipElementStack.length > 0) {
         Clay__int32_tArray_Set(&context->layoutElementClipElementIds, context->layoutElements.length - 1, Clay__int32_tArray_GetValue(&context->openClipElementStack, (int)context->openClipElementStack.length - 1));
     } else {
@@ -2017,7 +3001,7 @@ void Clay__OpenElement(void) {
 
 void Clay__OpenElementWithId(Clay_ElementId elementId) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
+    if ((context->layoutElements.length == context->layoutElements.capacity - 1 && !Clay__GrowElementArrays(context)) || context->booleanWarnings.maxElementsExceeded) {
         context->booleanWarnings.maxElementsExceeded = true;
         return;
     }
@@ -2027,6 +3011,9 @@ void Clay__OpenElementWithId(Clay_ElementId elementId) {
     Clay__int32_tArray_Add(&context->openLayoutElementStack, context->layoutElements.length - 1);
     Clay__AddHashMapItem(elementId, openLayoutElement);
     Clay__StringArray_Add(&context->layoutElementIdStrings, elementId.stringId);
+    if (context->layoutCachingEnabled) {
+        Clay__HashLayoutInput(context, elementId.id);
+    }
     if (context->openClipElementStack.length > 0) {
         Clay__int32_tArray_Set(&context->layoutElementClipElementIds, context->layoutElements.length - 1, Clay__int32_tArray_GetValue(&context->openClipElementStack, (int)context->openClipElementStack.length - 1));
     } else {
@@ -2036,7 +3023,10 @@ void Clay__OpenElementWithId(Clay_ElementId elementId) {
 
 void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
+    if ((context->layoutElements.length == context->layoutElements.capacity - 1 && !Clay__GrowElementArrays(context))
+            || (context->textElementData.length == context->textElementData.capacity && !Clay__GrowArrayToFit(context, &context->textElementData.capacity, context->textElementData.length + 1))
+            || (context->elementConfigs.length == context->elementConfigs.capacity && !Clay__GrowArrayToFit(context, &context->elementConfigs.capacity, context->elementConfigs.length + 1))
+            || context->booleanWarnings.maxElementsExceeded) {
         context->booleanWarnings.maxElementsExceeded = true;
         return;
     }
@@ -2066,11 +3056,216 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig)
     };
     textElement->layoutConfig = &CLAY_LAYOUT_DEFAULT;
     parentElement->childrenOrTextContent.children.length++;
+    if (context->layoutCachingEnabled) {
+        // Render commands reference the text by pointer, so the pointer is hashed along with the contents
+        Clay__HashLayoutInput(context, elementId.id);
+        Clay__HashLayoutInput(context, textMeasured->id);
+        Clay__HashLayoutInput(context, (uintptr_t)text.chars);
+        Clay__HashLayoutInput(context, (uint64_t)text.length);
+        Clay__HashLayoutInput(context, Clay__HashData((const uint8_t *)textConfig, sizeof(Clay_TextElementConfig)));
+    }
+}
+
+// Adds a request for every slice of the text that Clay__MeasureTextWords will measure, in the same order.
+// Returns false without adding anything if the requests don't fit in the current batch.
+bool Clay__AddTextMeasurementRequests(Clay__PendingTextMeasurement *pending) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__TextMeasurementRequestArray *requests = &context->textMeasurementRequests;
+    int32_t requestsStart = requests->length;
+    Clay_String *text = &pending->text;
+    // The space character is only requested by the first text using a font configuration, see Clay__GetSpaceWidth
+    Clay__FontMetrics *metrics = Clay__FindOrAddFontMetrics(pending->config);
+    bool requestSpace = !metrics || (!metrics->measured && !metrics->measurementRequested);
+    if (requestSpace) {
+        if (requests->length == requests->capacity) {
+            return false;
+        }
+        requests->internalArray[requests->length++] = CLAY__INIT(Clay_TextMeasurementRequest) { .text = { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, .config = pending->config };
+        if (metrics) {
+            metrics->measurementRequested = true;
+        }
+    }
+    int32_t start = 0;
+    for (int32_t end = 0; end <= text->length; ++end) {
+        if (end == text->length || text->chars[end] == ' ' || text->chars[end] == '\n') {
+            if (end > start) {
+                if (requests->length == requests->capacity) {
+                    requests->length = requestsStart;
+                    if (requestSpace && metrics) {
+                        metrics->measurementRequested = false;
+                    }
+                    return false;
+                }
+                requests->internalArray[requests->length++] = CLAY__INIT(Clay_TextMeasurementRequest) { .text = { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, .config = pending->config };
+            }
+            start = end + 1;
+        }
+    }
+    pending->requestCount = requests->length - requestsStart;
+    return true;
+}
+
+// Unlinks an item from the measure text hash map and frees it
+void Clay__RemoveMeasureTextCacheItem(int32_t itemIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__MeasureTextCacheItem *item = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, itemIndex);
+    uint32_t hashBucket = item->id % (context->maxMeasureTextCacheWordCount / 32);
+    int32_t elementIndex = context->measureTextHashMap.internalArray[hashBucket];
+    if (elementIndex == itemIndex) {
+        context->measureTextHashMap.internalArray[hashBucket] = item->nextIndex;
+    } else {
+        while (elementIndex != 0) {
+            Clay__MeasureTextCacheItem *hashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex);
+            if (hashEntry->nextIndex == itemIndex) {
+                hashEntry->nextIndex = item->nextIndex;
+                break;
+            }
+            elementIndex = hashEntry->nextIndex;
+        }
+    }
+    Clay__FreeCachedWrappedLines(item);
+    Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, itemIndex, CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1 });
+    Clay__int32_tArray_Add(&context->measureTextHashMapInternalFreeList, itemIndex);
+}
+
+// Calls the batch function with the current requests, then finishes the measurements of the pending text in [pendingStart, pendingEnd)
+void Clay__MeasurePendingTextBatch(int32_t pendingStart, int32_t pendingEnd) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->textMeasurementRequests.length > 0) {
+        context->textMeasurementResults.length = context->textMeasurementRequests.length;
+        CLAY_PROFILE_BEGIN(CLAY_PROFILE_PHASE_MEASURE_TEXT);
+        context->measureTextBatchFunction(context->textMeasurementRequests.internalArray, context->textMeasurementResults.internalArray, context->textMeasurementRequests.length, context->measureTextBatchUserData);
+        CLAY_PROFILE_END(CLAY_PROFILE_PHASE_MEASURE_TEXT, context->textMeasurementRequests.length);
+    }
+    int32_t resultIndex = 0;
+    for (int32_t i = pendingStart; i < pendingEnd; ++i) {
+        Clay__PendingTextMeasurement *pending = Clay__PendingTextMeasurementArray_Get(&context->pendingTextMeasurements, i);
+        Clay__MeasureTextCacheItem *measured = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, pending->cacheItemIndex);
+        measured->measurementPending = false;
+        context->textMeasurementResultIndex = resultIndex;
+        bool measuredWords = false;
+        if (pending->requestCount == -1) {
+            Clay__ReportTextMeasurementCapacityExceeded(); // The text has too many words to ever fit in the cache
+        } else {
+            measuredWords = Clay__MeasureTextWords(measured, &pending->text, pending->config);
+        }
+        if (!measuredWords) {
+            // Removed so that the text is measured again when it's next seen, as it would be without batching
+            Clay__RemoveMeasureTextCacheItem(pending->cacheItemIndex);
+        }
+        resultIndex += CLAY__MAX(pending->requestCount, 0);
+        if (pending->sharedCacheItemIndex != -1) {
+            Clay__PublishSharedMeasurement(context->sharedMeasureTextCache, pending->sharedCacheItemIndex, measuredWords ? measured : &Clay__MeasureTextCacheItem_DEFAULT);
+        }
+    }
+    context->textMeasurementResultIndex = -1;
+    context->textMeasurementRequests.length = 0;
+}
+
+// Measures all text that was first seen while the layout was being declared, in as few calls to the batch function as possible,
+// then sizes the text elements and every element that fits its children again.
+void Clay__MeasurePendingText(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->pendingTextMeasurements.length == 0 || context->booleanWarnings.maxElementsExceeded) {
+        // Items this context claimed in the shared cache are marked as failed, rather than being left pending forever
+        for (int32_t i = 0; i < context->pendingTextMeasurements.length; ++i) {
+            Clay__PendingTextMeasurement *pending = Clay__PendingTextMeasurementArray_Get(&context->pendingTextMeasurements, i);
+            if (pending->sharedCacheItemIndex != -1) {
+                Clay__PublishSharedMeasurement(context->sharedMeasureTextCache, pending->sharedCacheItemIndex, &Clay__MeasureTextCacheItem_DEFAULT);
+            }
+        }
+        context->pendingTextMeasurements.length = 0;
+        return;
+    }
+    int32_t pendingStart = 0;
+    for (int32_t i = 0; i < context->pendingTextMeasurements.length; ++i) {
+        Clay__PendingTextMeasurement *pending = Clay__PendingTextMeasurementArray_Get(&context->pendingTextMeasurements, i);
+        if (!Clay__AddTextMeasurementRequests(pending)) {
+            Clay__MeasurePendingTextBatch(pendingStart, i);
+            pendingStart = i;
+            if (!Clay__AddTextMeasurementRequests(pending)) {
+                pending->requestCount = -1;
+                Clay__MeasurePendingTextBatch(i, i + 1);
+                pendingStart = i + 1;
+            }
+        }
+    }
+    Clay__MeasurePendingTextBatch(pendingStart, context->pendingTextMeasurements.length);
+    context->pendingTextMeasurements.length = 0;
+
+    // Text that isn't in the cache anymore, because it failed to be measured or the cache was reset, is measured immediately
+    context->textMeasurementBatchingPaused = true;
+    for (int32_t i = 0; i < context->textElementData.length; ++i) {
+        Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&context->textElementData, i);
+        Clay_LayoutElement *textElement = Clay_LayoutElementArray_Get(&context->layoutElements, textElementData->elementIndex);
+        Clay_TextElementConfig *textConfig = Clay__FindElementConfigWithType(textElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig;
+        Clay__MeasureTextCacheItem *textMeasured = Clay__MeasureTextCached(&textElementData->text, textConfig);
+        textElement->dimensions = CLAY__INIT(Clay_Dimensions) { .width = textMeasured->unwrappedDimensions.width, .height = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textMeasured->unwrappedDimensions.height };
+        textElement->minDimensions = CLAY__INIT(Clay_Dimensions) { .width = textMeasured->minWidth, .height = textElement->dimensions.height };
+        textElementData->preferredDimensions = textMeasured->unwrappedDimensions;
+    }
+    context->textMeasurementBatchingPaused = false;
+
+    // Children are always declared after their parents
+    for (int32_t i = context->layoutElements.length - 1; i >= 0; --i) {
+        Clay_LayoutElement *layoutElement = Clay_LayoutElementArray_Get(&context->layoutElements, i);
+        if (!Clay__ElementHasConfig(layoutElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+            Clay__CalculateFitDimensions(layoutElement);
+        }
+    }
+}
+
+// Reserves space for the items of a virtual list that aren't declared
+void Clay__DeclareVirtualListSpacer(bool horizontal, float extent) {
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement(CLAY__INIT(Clay_ElementDeclaration) {
+        .layout = { .sizing = { horizontal ? CLAY_SIZING_FIXED(extent) : CLAY_SIZING_FIXED(0), horizontal ? CLAY_SIZING_FIXED(0) : CLAY_SIZING_FIXED(extent) } }
+    });
+    Clay__CloseElement();
+}
+
+// Declares the items of a virtual list that intersect the element's clip region, using the element's size from the previous frame,
+// and spacers in place of the items before and after them so that the scrollable size of the element is the same as if every item was declared.
+void Clay__DeclareVirtualListItems(const Clay_ElementDeclaration *declaration) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    const Clay_VirtualListElementConfig *virtualList = &declaration->virtualList;
+    Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
+    bool horizontal = declaration->layout.layoutDirection == CLAY_LEFT_TO_RIGHT;
+    float childGap = (float)declaration->layout.childGap;
+    float stride = virtualList->itemExtent + childGap;
+    int32_t firstIndex = 0;
+    int32_t lastIndex = virtualList->itemCount - 1;
+    if (stride > 0) {
+        // The bounding box is kept from the previous frame until the layout is calculated. On the first frame, the window size is used instead.
+        Clay_BoundingBox previousBoundingBox = Clay__GetHashMapItem(openLayoutElement->id)->boundingBox;
+        float viewportSize = horizontal ? previousBoundingBox.width : previousBoundingBox.height;
+        if (viewportSize <= 0) {
+            viewportSize = horizontal ? context->layoutDimensions.width : context->layoutDimensions.height;
+        }
+        float viewportStart = horizontal
+            ? -declaration->clip.childOffset.x - (float)declaration->layout.padding.left
+            : -declaration->clip.childOffset.y - (float)declaration->layout.padding.top;
+        firstIndex = CLAY__MAX((int32_t)(viewportStart / stride) - virtualList->overscan, 0);
+        lastIndex = CLAY__MIN((int32_t)((viewportStart + viewportSize) / stride) + virtualList->overscan, virtualList->itemCount - 1);
+        firstIndex = CLAY__MIN(firstIndex, lastIndex);
+    }
+    if (firstIndex > 0) {
+        Clay__DeclareVirtualListSpacer(horizontal, (float)firstIndex * stride - childGap);
+    }
+    for (int32_t i = firstIndex; i <= lastIndex; ++i) {
+        virtualList->declareItem(i, virtualList->userData);
+    }
+    if (lastIndex < virtualList->itemCount - 1) {
+        Clay__DeclareVirtualListSpacer(horizontal, (float)(virtualList->itemCount - 1 - lastIndex) * stride - childGap);
+    }
 }
 
 void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
     Clay_Context* context = Clay_GetCurrentContext();
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
+    if (context->layoutCachingEnabled) {
+        Clay__HashLayoutInput(context, Clay__HashData((const uint8_t *)declaration, sizeof(Clay_ElementDeclaration)));
+    }
     openLayoutElement->layoutConfig = Clay__StoreLayoutConfig(declaration->layout);
     if ((declaration->layout.sizing.width.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.width.size.percent > 1) || (declaration->layout.sizing.height.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.height.size.percent > 1)) {
         context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
@@ -2175,14 +3370,122 @@ void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
     if (!Clay__MemCmp((char *)(&declaration->border.width), (char *)(&Clay__BorderWidth_DEFAULT), sizeof(Clay_BorderWidth))) {
         Clay__AttachElementConfig(CLAY__INIT(Clay_ElementConfigUnion) { .borderElementConfig = Clay__StoreBorderElementConfig(declaration->border) }, CLAY__ELEMENT_CONFIG_TYPE_BORDER);
     }
+    if (declaration->virtualList.declareItem && declaration->virtualList.itemCount > 0) {
+        Clay__DeclareVirtualListItems(declaration);
+    }
 }
 
 void Clay__ConfigureOpenElement(const Clay_ElementDeclaration declaration) {
     Clay__ConfigureOpenElementPtr(&declaration);
 }
 
+// Commits the memory between start and end, rounded out to whole pages. Does nothing unless the arena is growable.
+bool Clay__CommitArenaRange(Clay_Context *context, char *start, char *end) {
+    if (!context->arenaMemoryFunctions.commitFunction || end <= start) {
+        return true;
+    }
+    uintptr_t pageStart = (uintptr_t)start & ~(uintptr_t)(CLAY__ARENA_PAGE_SIZE - 1);
+    uintptr_t pageEnd = ((uintptr_t)end + CLAY__ARENA_PAGE_SIZE - 1) & ~(uintptr_t)(CLAY__ARENA_PAGE_SIZE - 1);
+    if (!context->arenaMemoryFunctions.commitFunction((void *)pageStart, (size_t)(pageEnd - pageStart), context->arenaMemoryFunctions.userData)) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay failed to commit memory in its growable arena. The commit function passed to Clay_InitializeGrowable() returned false."),
+            .userData = context->errorHandler.userData });
+        return false;
+    }
+    return true;
+}
+
+// The capacity of a growable array with room reserved for maxCapacity items, when the context has memory for elementCapacity elements
+int32_t Clay__GrowableArrayCapacity(Clay_Context *context, Clay__GrowableArray *array, int32_t elementCapacity) {
+    return (int32_t)((int64_t)array->maxCapacity * elementCapacity / context->maxElementCount);
+}
+
+// Limits a growable array with room for maxCapacity items to its share of the context's element capacity, and registers it to grow
+// with the other arrays
+void Clay__AddGrowableArray(Clay_Context *context, int32_t *capacity, int32_t *length, void *memory, uint32_t itemSize, int32_t maxCapacity) {
+    Clay__GrowableArray array = { .capacity = capacity, .length = length, .memory = (char *)memory, .itemSize = itemSize, .maxCapacity = maxCapacity };
+    *capacity = Clay__GrowableArrayCapacity(context, &array, context->elementCapacity);
+    if (length) {
+        *length = *capacity;
+    }
+    Clay__GrowableArrayArray_Add(&context->growableArrays, array);
+}
+
+#define CLAY__ADD_GROWABLE_ARRAY(array, accessedDirectly) Clay__AddGrowableArray(context, &(array).capacity, (accessedDirectly) ? &(array).length : CLAY__NULL, (array).internalArray, sizeof(*(array).internalArray), (array).capacity)
+
+// Commits all of the arena's memory, except for the space reserved for growable arrays beyond the element capacity
+void Clay__CommitArenaMemory(Clay_Context *context) {
+    char *committedEnd = context->internalArena.memory;
+    for (int32_t i = 0; i < context->growableArrays.length; ++i) {
+        Clay__GrowableArray *array = &context->growableArrays.internalArray[i];
+        Clay__CommitArenaRange(context, committedEnd, array->memory + (size_t)*array->capacity * array->itemSize);
+        committedEnd = array->memory + (size_t)array->maxCapacity * array->itemSize;
+    }
+    Clay__CommitArenaRange(context, committedEnd, context->internalArena.memory + context->internalArena.nextAllocation);
+}
+
+// Doubles the element capacity of a growable arena, committing memory for every growable array. Returns false if the arena isn't
+// growable, or already has room for maxElementCount elements.
+bool Clay__GrowElementArrays(Clay_Context *context) {
+    if (!context->arenaMemoryFunctions.commitFunction || context->elementCapacity >= context->maxElementCount) {
+        return false;
+    }
+    int32_t elementCapacity = CLAY__MIN(context->elementCapacity * 2, context->maxElementCount);
+    for (int32_t i = 0; i < context->growableArrays.length; ++i) {
+        Clay__GrowableArray *array = &context->growableArrays.internalArray[i];
+        if (!Clay__CommitArenaRange(context, array->memory + (size_t)*array->capacity * array->itemSize, array->memory + (size_t)Clay__GrowableArrayCapacity(context, array, elementCapacity) * array->itemSize)) {
+            return false;
+        }
+    }
+    for (int32_t i = 0; i < context->growableArrays.length; ++i) {
+        Clay__GrowableArray *array = &context->growableArrays.internalArray[i];
+        *array->capacity = Clay__GrowableArrayCapacity(context, array, elementCapacity);
+        if (array->length) {
+            *array->length = *array->capacity;
+        }
+    }
+    context->elementCapacity = elementCapacity;
+    context->memoryStats.arenaGrowCount++;
+    return true;
+}
+
+// Grows the element arrays until the registered array with the given capacity has room for requiredCapacity items.
+// Returns false if it can't, including when the array isn't growable.
+bool Clay__GrowArrayToFit(Clay_Context *context, int32_t *capacity, int32_t requiredCapacity) {
+    if (!context->arenaMemoryFunctions.commitFunction) {
+        return false;
+    }
+    bool registered = false;
+    for (int32_t i = 0; i < context->growableArrays.length; ++i) {
+        if (context->growableArrays.internalArray[i].capacity == capacity) {
+            registered = true;
+            break;
+        }
+    }
+    while (registered && *capacity < requiredCapacity) {
+        if (!Clay__GrowElementArrays(context)) {
+            return false;
+        }
+    }
+    return registered;
+}
+
+// Replaces capacities of 0 with their defaults, except for diffedRenderCommands which is disabled by default
+Clay_ArrayCapacities Clay__ResolveArrayCapacities(Clay_ArrayCapacities capacities, int32_t maxElementCount) {
+    return CLAY__INIT(Clay_ArrayCapacities) {
+        .elementConfigs = capacities.elementConfigs > 0 ? capacities.elementConfigs : maxElementCount,
+        .elementConfigBytes = capacities.elementConfigBytes > 0 ? capacities.elementConfigBytes : maxElementCount * CLAY__DEFAULT_ELEMENT_CONFIG_BYTES_PER_ELEMENT,
+        .textElements = capacities.textElements > 0 ? capacities.textElements : maxElementCount,
+        .wrappedTextLines = capacities.wrappedTextLines > 0 ? capacities.wrappedTextLines : maxElementCount,
+        .debugStringBytes = capacities.debugStringBytes > 0 ? capacities.debugStringBytes : maxElementCount,
+        .diffedRenderCommands = CLAY__MAX(capacities.diffedRenderCommands, 0),
+    };
+}
+
 void Clay__InitializeEphemeralMemory(Clay_Context* context) {
     int32_t maxElementCount = context->maxElementCount;
+    Clay_ArrayCapacities capacities = Clay__ResolveArrayCapacities(context->arrayCapacities, maxElementCount);
     // Ephemeral Memory - reset every frame
     Clay_Arena *arena = &context->internalArena;
     arena->nextAllocation = context->arenaResetOffset;
@@ -2192,280 +3495,639 @@ void Clay__InitializeEphemeralMemory(Clay_Context* context) {
     context->warnings = Clay__WarningArray_Allocate_Arena(100, arena);
 
     context->layoutConfigs = Clay__LayoutConfigArray_Allocate_Arena(maxElementCount, arena);
-    context->elementConfigs = Clay__ElementConfigArray_Allocate_Arena(maxElementCount, arena);
-    context->textElementConfigs = Clay__TextElementConfigArray_Allocate_Arena(maxElementCount, arena);
-    context->aspectRatioElementConfigs = Clay__AspectRatioElementConfigArray_Allocate_Arena(maxElementCount, arena);
-    context->imageElementConfigs = Clay__ImageElementConfigArray_Allocate_Arena(maxElementCount, arena);
-    context->floatingElementConfigs = Clay__FloatingElementConfigArray_Allocate_Arena(maxElementCount, arena);
-    context->clipElementConfigs = Clay__ClipElementConfigArray_Allocate_Arena(maxElementCount, arena);
-    context->customElementConfigs = Clay__CustomElementConfigArray_Allocate_Arena(maxElementCount, arena);
-    context->borderElementConfigs = Clay__BorderElementConfigArray_Allocate_Arena(maxElementCount, arena);
-    context->sharedElementConfigs = Clay__SharedElementConfigArray_Allocate_Arena(maxElementCount, arena);
+    context->elementConfigs = Clay__ElementConfigArray_Allocate_Arena(capacities.elementConfigs, arena);
+    context->elementConfigPool = Clay__charArray_Allocate_Arena(capacities.elementConfigBytes, arena);
 
     context->layoutElementIdStrings = Clay__StringArray_Allocate_Arena(maxElementCount, arena);
-    context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(maxElementCount, arena);
+    context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(capacities.wrappedTextLines, arena);
     context->layoutElementTreeNodeArray1 = Clay__LayoutElementTreeNodeArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementTreeRoots = Clay__LayoutElementTreeRootArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementChildren = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->openLayoutElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->textElementData = Clay__TextElementDataArray_Allocate_Arena(maxElementCount, arena);
+    context->textElementData = Clay__TextElementDataArray_Allocate_Arena(capacities.textElements, arena);
     context->aspectRatioElementIndexes = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->renderCommands = Clay_RenderCommandArray_Allocate_Arena(maxElementCount, arena);
     context->treeNodeVisited = Clay__boolArray_Allocate_Arena(maxElementCount, arena);
     context->treeNodeVisited.length = context->treeNodeVisited.capacity; // This array is accessed directly rather than behaving as a list
+    context->layoutElementHitTestBounds = Clay__ElementHitTestBoundsArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementHitTestBounds.length = context->layoutElementHitTestBounds.capacity; // This array is accessed directly rather than behaving as a list
     context->openClipElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->reusableElementIndexBuffer = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementClipElementIds = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->dynamicStringData = Clay__charArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementSubtreeSizes = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementSubtreeSizes.length = context->layoutElementSubtreeSizes.capacity; // This array is accessed directly rather than behaving as a list
+    context->layoutElementSubtreeContained = Clay__boolArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementSubtreeContained.length = context->layoutElementSubtreeContained.capacity; // This array is accessed directly rather than behaving as a list
+    context->resizableContainerBuffer = Clay__ResizableContainerBuffer_Allocate_Arena(maxElementCount, arena);
+    context->dynamicStringData = Clay__charArray_Allocate_Arena(capacities.debugStringBytes, arena);
+    context->pendingTextMeasurements = Clay__PendingTextMeasurementArray_Allocate_Arena(capacities.textElements, arena);
+    // Sized so that any text that fits in the measure text cache fits in a single batch
+    context->textMeasurementRequests = Clay__TextMeasurementRequestArray_Allocate_Arena(context->maxMeasureTextCacheWordCount, arena);
+    context->textMeasurementResults = Clay__DimensionsArray_Allocate_Arena(context->maxMeasureTextCacheWordCount, arena);
+    context->textMeasurementResultIndex = -1;
+    context->renderCommandDiff = CLAY__INIT(Clay_RenderCommandDiff) {
+        .inserted = Clay_RenderCommandArray_Allocate_Arena(capacities.diffedRenderCommands, arena),
+        .removed = Clay_RenderCommandArray_Allocate_Arena(capacities.diffedRenderCommands, arena),
+        .modified = Clay_RenderCommandArray_Allocate_Arena(capacities.diffedRenderCommands, arena),
+        .previousModified = Clay_RenderCommandArray_Allocate_Arena(capacities.diffedRenderCommands, arena),
+    };
+    context->damageRectangles = Clay_BoundingBoxArray_Allocate_Arena(CLAY__MAX_DAMAGE_RECTANGLES, arena);
+
+    if (context->arenaMemoryFunctions.commitFunction) {
+        // Registered in allocation order, which Clay__CommitArenaMemory relies on
+        context->growableArrays.length = context->persistentGrowableArrayCount;
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementChildrenBuffer, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElements, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutConfigs, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->elementConfigs, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->elementConfigPool, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementIdStrings, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->wrappedTextLines, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementTreeNodeArray1, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementTreeRoots, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementChildren, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->openLayoutElementStack, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->textElementData, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->aspectRatioElementIndexes, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->renderCommands, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->treeNodeVisited, true);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementHitTestBounds, true);
+        CLAY__ADD_GROWABLE_ARRAY(context->openClipElementStack, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->reusableElementIndexBuffer, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementClipElementIds, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementSubtreeSizes, true);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementSubtreeContained, true);
+        Clay__ResizableContainerBuffer *resizableContainerBuffer = &context->resizableContainerBuffer;
+        // All of the buffer's arrays share one capacity
+        int32_t bufferCapacity = resizableContainerBuffer->capacity;
+        Clay__AddGrowableArray(context, &resizableContainerBuffer->capacity, CLAY__NULL, resizableContainerBuffer->elementIndexes, sizeof(int32_t), bufferCapacity);
+        Clay__AddGrowableArray(context, &resizableContainerBuffer->capacity, CLAY__NULL, resizableContainerBuffer->sizes, sizeof(float), bufferCapacity);
+        Clay__AddGrowableArray(context, &resizableContainerBuffer->capacity, CLAY__NULL, resizableContainerBuffer->minSizes, sizeof(float), bufferCapacity);
+        Clay__AddGrowableArray(context, &resizableContainerBuffer->capacity, CLAY__NULL, resizableContainerBuffer->maxSizes, sizeof(float), bufferCapacity);
+        Clay__AddGrowableArray(context, &resizableContainerBuffer->capacity, CLAY__NULL, resizableContainerBuffer->sizingTypes, sizeof(Clay__SizingType), bufferCapacity);
+        CLAY__ADD_GROWABLE_ARRAY(context->dynamicStringData, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->pendingTextMeasurements, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->renderCommandDiff.inserted, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->renderCommandDiff.removed, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->renderCommandDiff.modified, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->renderCommandDiff.previousModified, false);
+    }
+}
+
+void Clay__InitializePersistentMemory(Clay_Context* context) {
+    // Persistent memory - initialized once and not reset
+    int32_t maxElementCount = context->maxElementCount;
+    int32_t maxMeasureTextCacheWordCount = context->maxMeasureTextCacheWordCount;
+    Clay_ArrayCapacities capacities = Clay__ResolveArrayCapacities(context->arrayCapacities, maxElementCount);
+    Clay_Arena *arena = &context->internalArena;
+
+    // Allocated even if the arena isn't growable, so that it's included in Clay_MinMemorySize()
+    context->growableArrays = Clay__GrowableArrayArray_Allocate_Arena(CLAY__MAX_GROWABLE_ARRAYS, arena);
+    Clay__CommitArenaRange(context, (char *)context->growableArrays.internalArray, (char *)(context->growableArrays.internalArray + context->growableArrays.capacity));
+    context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(100, arena);
+    context->layoutElementsHashMapInternal = Clay__LayoutElementHashMapItemArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementsHashMapColdData = Clay__LayoutElementHashMapItemColdDataArray_Allocate_Arena(maxElementCount, arena);
+    // Power of two number of groups, with at least twice as many slots as items to keep probe sequences short
+    int32_t hashMapGroupCount = 1;
+    while (hashMapGroupCount * CLAY__HASH_MAP_GROUP_SIZE < maxElementCount * 2) {
+        hashMapGroupCount *= 2;
+    }
+    context->layoutElementsHashMap = Clay__LayoutElementHashMapGroupArray_Allocate_Arena(hashMapGroupCount, arena);
+    context->layoutElementsHashMap.length = context->layoutElementsHashMap.capacity; // This array is accessed directly rather than behaving as a list
+    context->measureTextHashMapInternal = Clay__MeasureTextCacheItemArray_Allocate_Arena(maxElementCount, arena);
+    context->measureTextHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->measuredWordsFreeList = Clay__int32_tArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
+    context->measureTextHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->measuredWords = Clay__MeasuredWordArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
+    // Every wrapped line holds at least one word, and usually several
+    context->cachedWrappedLines = Clay__CachedWrappedLineArray_Allocate_Arena(maxMeasureTextCacheWordCount / 4, arena);
+    context->cachedWrappedLinesFreeList = Clay__int32_tArray_Allocate_Arena(maxMeasureTextCacheWordCount / 4, arena);
+    context->fontMetrics = Clay__FontMetricsArray_Allocate_Arena(CLAY__FONT_METRICS_CAPACITY, arena);
+    context->pointerOverIds = Clay_ElementIdArray_Allocate_Arena(maxElementCount, arena);
+    context->debugElementData = Clay__DebugElementDataArray_Allocate_Arena(maxElementCount, arena);
+    context->cachedLayoutElementDimensions = Clay__DimensionsArray_Allocate_Arena(maxElementCount, arena);
+    context->cachedLayoutElementDimensions.length = context->cachedLayoutElementDimensions.capacity; // This array is accessed directly rather than behaving as a list
+    context->previousRenderCommands = Clay_RenderCommandArray_Allocate_Arena(capacities.diffedRenderCommands, arena);
+    context->renderCommandSnapshots = Clay__RenderCommandSnapshotArray_Allocate_Arena(capacities.diffedRenderCommands, arena);
+    context->previousRenderCommandSnapshots = Clay__RenderCommandSnapshotArray_Allocate_Arena(capacities.diffedRenderCommands, arena);
+    // Power of two size, with at least twice as many slots as commands to keep probe sequences short
+    int32_t diffHashMapCapacity = 1;
+    while (diffHashMapCapacity < capacities.diffedRenderCommands * 2) {
+        diffHashMapCapacity *= 2;
+    }
+    context->renderCommandDiffHashMap = Clay__int32_tArray_Allocate_Arena(diffHashMapCapacity, arena);
+    context->renderCommandDiffHashMap.length = context->renderCommandDiffHashMap.capacity; // This array is accessed directly rather than behaving as a list
+    context->arenaResetOffset = arena->nextAllocation;
+
+    if (context->arenaMemoryFunctions.commitFunction) {
+        // Registered in allocation order, which Clay__CommitArenaMemory relies on
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementsHashMapInternal, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->layoutElementsHashMapColdData, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->measureTextHashMapInternal, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->measureTextHashMapInternalFreeList, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->pointerOverIds, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->debugElementData, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->cachedLayoutElementDimensions, true);
+        CLAY__ADD_GROWABLE_ARRAY(context->previousRenderCommands, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->renderCommandSnapshots, false);
+        CLAY__ADD_GROWABLE_ARRAY(context->previousRenderCommandSnapshots, false);
+        context->persistentGrowableArrayCount = context->growableArrays.length;
+    }
+}
+
+const float CLAY__EPSILON = 0.01;
+
+bool Clay__FloatEqual(float left, float right) {
+    float subtracted = left - right;
+    return subtracted < CLAY__EPSILON && subtracted > -CLAY__EPSILON;
+}
+
+// One step of the scan for the smallest size while distributing space. Sizes within CLAY__EPSILON of the current smallest are
+// skipped, and widthToAdd is only updated when a size larger than the current smallest is seen, so the result depends on order.
+// The gap is calculated from the unsigned sizes so that it rounds the same way when scanning for the largest size.
+void Clay__ScanSmallestSize(float size, float sign, float *smallest, float *secondSmallest, float *widthToAdd) {
+    if (Clay__FloatEqual(size, *smallest)) { return; }
+    if (size < *smallest) {
+        *secondSmallest = *smallest;
+        *smallest = size;
+    }
+    if (size > *smallest) {
+        *secondSmallest = CLAY__MIN(*secondSmallest, size);
+        *widthToAdd = sign * (sign * *secondSmallest - sign * *smallest);
+    }
+}
+
+// Runs Clay__ScanSmallestSize over sign * sizes[i] for every size in order. A sign of -1 scans for the largest size, with negated results.
+// Blocks of sizes that don't contain a new smallest size can be applied in any order, so they are handled four at a time,
+// and only blocks that do are stepped through one size at a time. The result is identical to the sequential scan.
+void Clay__ScanSmallestSizes(const float *sizes, int32_t count, float sign, float *smallestOut, float *secondSmallestOut, float *widthToAddOut) {
+    // Copied to locals, as the outputs could otherwise alias the sizes
+    float smallest = *smallestOut, secondSmallest = *secondSmallestOut, widthToAdd = *widthToAddOut;
+    int32_t i = 0;
+#if !defined(CLAY_DISABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64))
+    const __m128 signs = _mm_set1_ps(sign);
+    const __m128 epsilon = _mm_set1_ps(CLAY__EPSILON);
+    const __m128 negativeEpsilon = _mm_set1_ps(-CLAY__EPSILON);
+    const __m128 maxFloat = _mm_set1_ps(CLAY__MAXFLOAT);
+    for (; i + 4 <= count; i += 4) {
+        __m128 block = _mm_mul_ps(_mm_loadu_ps(sizes + i), signs);
+        __m128 current = _mm_set1_ps(smallest);
+        __m128 subtracted = _mm_sub_ps(block, current);
+        __m128 equal = _mm_and_ps(_mm_cmplt_ps(subtracted, epsilon), _mm_cmpgt_ps(subtracted, negativeEpsilon));
+        if (_mm_movemask_ps(_mm_andnot_ps(equal, _mm_cmplt_ps(block, current)))) {
+            for (int32_t j = i; j < i + 4; ++j) {
+                Clay__ScanSmallestSize(sign * sizes[j], sign, &smallest, &secondSmallest, &widthToAdd);
+            }
+            continue;
+        }
+        __m128 larger = _mm_andnot_ps(equal, _mm_cmpgt_ps(block, current));
+        if (_mm_movemask_ps(larger)) {
+            __m128 candidates = _mm_or_ps(_mm_and_ps(larger, block), _mm_andnot_ps(larger, maxFloat));
+            candidates = _mm_min_ps(candidates, _mm_shuffle_ps(candidates, candidates, _MM_SHUFFLE(2, 3, 0, 1)));
+            candidates = _mm_min_ps(candidates, _mm_shuffle_ps(candidates, candidates, _MM_SHUFFLE(1, 0, 3, 2)));
+            secondSmallest = CLAY__MIN(secondSmallest, _mm_cvtss_f32(candidates));
+            widthToAdd = sign * (sign * secondSmallest - sign * smallest);
+        }
+    }
+#elif !defined(CLAY_DISABLE_SIMD) && defined(__aarch64__)
+    const float32x4_t epsilon = vdupq_n_f32(CLAY__EPSILON);
+    const float32x4_t negativeEpsilon = vdupq_n_f32(-CLAY__EPSILON);
+    const float32x4_t maxFloat = vdupq_n_f32(CLAY__MAXFLOAT);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t block = vmulq_n_f32(vld1q_f32(sizes + i), sign);
+        float32x4_t current = vdupq_n_f32(smallest);
+        float32x4_t subtracted = vsubq_f32(block, current);
+        uint32x4_t equal = vandq_u32(vcltq_f32(subtracted, epsilon), vcgtq_f32(subtracted, negativeEpsilon));
+        if (vmaxvq_u32(vbicq_u32(vcltq_f32(block, current), equal))) {
+            for (int32_t j = i; j < i + 4; ++j) {
+                Clay__ScanSmallestSize(sign * sizes[j], sign, &smallest, &secondSmallest, &widthToAdd);
+            }
+            continue;
+        }
+        uint32x4_t larger = vbicq_u32(vcgtq_f32(block, current), equal);
+        if (vmaxvq_u32(larger)) {
+            secondSmallest = CLAY__MIN(secondSmallest, vminvq_f32(vbslq_f32(larger, block, maxFloat)));
+            widthToAdd = sign * (sign * secondSmallest - sign * smallest);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        Clay__ScanSmallestSize(sign * sizes[i], sign, &smallest, &secondSmallest, &widthToAdd);
+    }
+    *smallestOut = smallest;
+    *secondSmallestOut = secondSmallest;
+    *widthToAddOut = widthToAdd;
 }
 
-void Clay__InitializePersistentMemory(Clay_Context* context) {
-    // Persistent memory - initialized once and not reset
-    int32_t maxElementCount = context->maxElementCount;
-    int32_t maxMeasureTextCacheWordCount = context->maxMeasureTextCacheWordCount;
-    Clay_Arena *arena = &context->internalArena;
-
-    context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(100, arena);
-    context->layoutElementsHashMapInternal = Clay__LayoutElementHashMapItemArray_Allocate_Arena(maxElementCount, arena);
-    context->layoutElementsHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->measureTextHashMapInternal = Clay__MeasureTextCacheItemArray_Allocate_Arena(maxElementCount, arena);
-    context->measureTextHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->measuredWordsFreeList = Clay__int32_tArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
-    context->measureTextHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->measuredWords = Clay__MeasuredWordArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
-    context->pointerOverIds = Clay_ElementIdArray_Allocate_Arena(maxElementCount, arena);
-    context->debugElementData = Clay__DebugElementDataArray_Allocate_Arena(maxElementCount, arena);
-    context->arenaResetOffset = arena->nextAllocation;
+// Returns the index of the first size from start onwards that is within CLAY__EPSILON of size, or count if there isn't one
+int32_t Clay__FindEqualSize(const float *sizes, int32_t start, int32_t count, float size) {
+    // Most sizes that are equal are next to each other, after the first pass has made them equal
+    if (start < count && Clay__FloatEqual(sizes[start], size)) {
+        return start;
+    }
+    int32_t i = start;
+#if !defined(CLAY_DISABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64))
+    const __m128 epsilon = _mm_set1_ps(CLAY__EPSILON);
+    const __m128 negativeEpsilon = _mm_set1_ps(-CLAY__EPSILON);
+    const __m128 target = _mm_set1_ps(size);
+    for (; i + 4 <= count; i += 4) {
+        __m128 subtracted = _mm_sub_ps(_mm_loadu_ps(sizes + i), target);
+        int32_t matches = _mm_movemask_ps(_mm_and_ps(_mm_cmplt_ps(subtracted, epsilon), _mm_cmpgt_ps(subtracted, negativeEpsilon)));
+        if (matches) {
+            return i + Clay__CountTrailingZeros((uint32_t)matches);
+        }
+    }
+#elif !defined(CLAY_DISABLE_SIMD) && defined(__aarch64__)
+    const float32x4_t epsilon = vdupq_n_f32(CLAY__EPSILON);
+    const float32x4_t negativeEpsilon = vdupq_n_f32(-CLAY__EPSILON);
+    const float32x4_t target = vdupq_n_f32(size);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t subtracted = vsubq_f32(vld1q_f32(sizes + i), target);
+        if (vmaxvq_u32(vandq_u32(vcltq_f32(subtracted, epsilon), vcgtq_f32(subtracted, negativeEpsilon)))) {
+            break; // The scalar loop below finds the matching lane
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        if (Clay__FloatEqual(sizes[i], size)) {
+            return i;
+        }
+    }
+    return count;
 }
 
-const float CLAY__EPSILON = 0.01;
+// Sizes a floating tree root relative to its parent, and clamps any tree root to its min and max size
+void Clay__SizeTreeRoot(Clay__LayoutElementTreeRoot *root) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
+    // Size floating containers to their parents
+    if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
+        Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
+        Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(floatingElementConfig->parentId);
+        if (parentItem && parentItem != &Clay_LayoutElementHashMapItem_DEFAULT) {
+            Clay_LayoutElement *parentLayoutElement = parentItem->layoutElement;
+            switch (rootElement->layoutConfig->sizing.width.type) {
+                case CLAY__SIZING_TYPE_GROW: {
+                    rootElement->dimensions.width = parentLayoutElement->dimensions.width;
+                    break;
+                }
+                case CLAY__SIZING_TYPE_PERCENT: {
+                    rootElement->dimensions.width = parentLayoutElement->dimensions.width * rootElement->layoutConfig->sizing.width.size.percent;
+                    break;
+                }
+                default: break;
+            }
+            switch (rootElement->layoutConfig->sizing.height.type) {
+                case CLAY__SIZING_TYPE_GROW: {
+                    rootElement->dimensions.height = parentLayoutElement->dimensions.height;
+                    break;
+                }
+                case CLAY__SIZING_TYPE_PERCENT: {
+                    rootElement->dimensions.height = parentLayoutElement->dimensions.height * rootElement->layoutConfig->sizing.height.size.percent;
+                    break;
+                }
+                default: break;
+            }
+        }
+    }
 
-bool Clay__FloatEqual(float left, float right) {
-    float subtracted = left - right;
-    return subtracted < CLAY__EPSILON && subtracted > -CLAY__EPSILON;
+    if (rootElement->layoutConfig->sizing.width.type != CLAY__SIZING_TYPE_PERCENT) {
+        rootElement->dimensions.width = CLAY__MIN(CLAY__MAX(rootElement->dimensions.width, rootElement->layoutConfig->sizing.width.size.minMax.min), rootElement->layoutConfig->sizing.width.size.minMax.max);
+    }
+    if (rootElement->layoutConfig->sizing.height.type != CLAY__SIZING_TYPE_PERCENT) {
+        rootElement->dimensions.height = CLAY__MIN(CLAY__MAX(rootElement->dimensions.height, rootElement->layoutConfig->sizing.height.size.minMax.min), rootElement->layoutConfig->sizing.height.size.minMax.max);
+    }
 }
 
-void Clay__SizeContainersAlongAxis(bool xAxis) {
+// Sizes the children of a single element along one axis, and queues any children that have children of their own
+void Clay__SizeChildrenAlongAxis(bool xAxis, int32_t parentIndex, Clay__int32_tArray *bfsBuffer, Clay__ResizableContainerBuffer *resizableContainerBuffer) {
     Clay_Context* context = Clay_GetCurrentContext();
-    Clay__int32_tArray bfsBuffer = context->layoutElementChildrenBuffer;
-    Clay__int32_tArray resizableContainerBuffer = context->openLayoutElementStack;
-    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
-        bfsBuffer.length = 0;
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
-        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
-        Clay__int32_tArray_Add(&bfsBuffer, (int32_t)root->layoutElementIndex);
+    Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&context->layoutElements, parentIndex);
+    Clay_LayoutConfig *parentStyleConfig = parent->layoutConfig;
+    int32_t growContainerCount = 0;
+    float parentSize = xAxis ? parent->dimensions.width : parent->dimensions.height;
+    float parentPadding = (float)(xAxis ? (parent->layoutConfig->padding.left + parent->layoutConfig->padding.right) : (parent->layoutConfig->padding.top + parent->layoutConfig->padding.bottom));
+    float innerContentSize = 0, totalPaddingAndChildGaps = parentPadding;
+    bool sizingAlongAxis = (xAxis && parentStyleConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) || (!xAxis && parentStyleConfig->layoutDirection == CLAY_TOP_TO_BOTTOM);
+    resizableContainerBuffer->length = 0;
+    float parentChildGap = parentStyleConfig->childGap;
+
+    for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
+        int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
+        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
+        Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
+        float childSize = xAxis ? childElement->dimensions.width : childElement->dimensions.height;
+
+        if (!Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) && childElement->childrenOrTextContent.children.length > 0) {
+            Clay__int32_tArray_Add(bfsBuffer, childElementIndex);
+        }
 
-        // Size floating containers to their parents
-        if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
-            Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
-            Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(floatingElementConfig->parentId);
-            if (parentItem && parentItem != &Clay_LayoutElementHashMapItem_DEFAULT) {
-                Clay_LayoutElement *parentLayoutElement = parentItem->layoutElement;
-                switch (rootElement->layoutConfig->sizing.width.type) {
-                    case CLAY__SIZING_TYPE_GROW: {
-                        rootElement->dimensions.width = parentLayoutElement->dimensions.width;
-                        break;
+        if (childSizing.type != CLAY__SIZING_TYPE_PERCENT
+            && childSizing.type != CLAY__SIZING_TYPE_FIXED
+            && (!Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || (Clay__FindElementConfigWithType(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig->wrapMode == CLAY_TEXT_WRAP_WORDS)) // todo too many loops
+//            && (xAxis || !Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT))
+        ) {
+            float minSize = xAxis ? childElement->minDimensions.width : childElement->minDimensions.height;
+            Clay__ResizableContainerBuffer_Add(resizableContainerBuffer, childElementIndex, childSize, minSize, childSizing.size.minMax.max, childSizing.type);
+        }
+        if (sizingAlongAxis) {
+            innerContentSize += (childSizing.type == CLAY__SIZING_TYPE_PERCENT ? 0 : childSize);
+            if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
+                growContainerCount++;
+            }
+            if (childOffset > 0) {
+                innerContentSize += parentChildGap; // For children after index 0, the childAxisOffset is the gap from the previous child
+                totalPaddingAndChildGaps += parentChildGap;
+            }
+        } else {
+            innerContentSize = CLAY__MAX(childSize, innerContentSize);
+        }
+    }
+
+    // Expand percentage containers to size
+    for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
+        int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
+        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
+        Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
+        float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
+        if (childSizing.type == CLAY__SIZING_TYPE_PERCENT) {
+            *childSize = (parentSize - totalPaddingAndChildGaps) * childSizing.size.percent;
+            if (sizingAlongAxis) {
+                innerContentSize += *childSize;
+            }
+            Clay__UpdateAspectRatioBox(childElement);
+        }
+    }
+
+    int32_t resizableContainerCount = resizableContainerBuffer->length;
+    float *sizes = resizableContainerBuffer->sizes;
+    if (sizingAlongAxis) {
+        float sizeToDistribute = parentSize - parentPadding - innerContentSize;
+        // The content is too large, compress the children as much as possible
+        if (sizeToDistribute < 0) {
+            // If the parent clips content in this axis direction, don't compress children, just leave them alone
+            Clay_ClipElementConfig *clipElementConfig = Clay__FindElementConfigWithType(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+            if (clipElementConfig) {
+                if (((xAxis && clipElementConfig->horizontal) || (!xAxis && clipElementConfig->vertical))) {
+                    return;
+                }
+            }
+            // Scrolling containers preferentially compress before others
+            while (sizeToDistribute < -CLAY__EPSILON && resizableContainerBuffer->length > 0) {
+                // Scanned as negated sizes, so these are the negated largest and second largest sizes
+                float negatedLargest = -0.f;
+                float negatedSecondLargest = -0.f;
+                float negatedWidthToAdd = -sizeToDistribute;
+                Clay__ScanSmallestSizes(sizes, resizableContainerBuffer->length, -1, &negatedLargest, &negatedSecondLargest, &negatedWidthToAdd);
+                float largest = -negatedLargest;
+
+                float widthToAdd = CLAY__MAX(-negatedWidthToAdd, sizeToDistribute / resizableContainerBuffer->length);
+
+                for (int childIndex = Clay__FindEqualSize(sizes, 0, resizableContainerBuffer->length, largest); childIndex < resizableContainerBuffer->length; childIndex = Clay__FindEqualSize(sizes, childIndex + 1, resizableContainerBuffer->length, largest)) {
+                    float previousWidth = sizes[childIndex];
+                    float childSize = previousWidth + widthToAdd;
+                    bool reachedMinSize = childSize <= resizableContainerBuffer->minSizes[childIndex];
+                    if (reachedMinSize) {
+                        childSize = resizableContainerBuffer->minSizes[childIndex];
                     }
-                    case CLAY__SIZING_TYPE_PERCENT: {
-                        rootElement->dimensions.width = parentLayoutElement->dimensions.width * rootElement->layoutConfig->sizing.width.size.percent;
-                        break;
+                    sizes[childIndex] = childSize;
+                    sizeToDistribute -= (childSize - previousWidth);
+                    if (reachedMinSize) {
+                        Clay__ResizableContainerBuffer_RemoveSwapback(resizableContainerBuffer, childIndex--);
                     }
-                    default: break;
                 }
-                switch (rootElement->layoutConfig->sizing.height.type) {
-                    case CLAY__SIZING_TYPE_GROW: {
-                        rootElement->dimensions.height = parentLayoutElement->dimensions.height;
-                        break;
+            }
+        // The content is too small, allow SIZING_GROW containers to expand
+        } else if (sizeToDistribute > 0 && growContainerCount > 0) {
+            for (int childIndex = 0; childIndex < resizableContainerBuffer->length; childIndex++) {
+                if (resizableContainerBuffer->sizingTypes[childIndex] != CLAY__SIZING_TYPE_GROW) {
+                    Clay__ResizableContainerBuffer_RemoveSwapback(resizableContainerBuffer, childIndex--);
+                }
+            }
+            while (sizeToDistribute > CLAY__EPSILON && resizableContainerBuffer->length > 0) {
+                float smallest = CLAY__MAXFLOAT;
+                float secondSmallest = CLAY__MAXFLOAT;
+                float widthToAdd = sizeToDistribute;
+                Clay__ScanSmallestSizes(sizes, resizableContainerBuffer->length, 1, &smallest, &secondSmallest, &widthToAdd);
+
+                widthToAdd = CLAY__MIN(widthToAdd, sizeToDistribute / resizableContainerBuffer->length);
+
+                for (int childIndex = Clay__FindEqualSize(sizes, 0, resizableContainerBuffer->length, smallest); childIndex < resizableContainerBuffer->length; childIndex = Clay__FindEqualSize(sizes, childIndex + 1, resizableContainerBuffer->length, smallest)) {
+                    float previousWidth = sizes[childIndex];
+                    float childSize = previousWidth + widthToAdd;
+                    bool reachedMaxSize = childSize >= resizableContainerBuffer->maxSizes[childIndex];
+                    if (reachedMaxSize) {
+                        childSize = resizableContainerBuffer->maxSizes[childIndex];
                     }
-                    case CLAY__SIZING_TYPE_PERCENT: {
-                        rootElement->dimensions.height = parentLayoutElement->dimensions.height * rootElement->layoutConfig->sizing.height.size.percent;
-                        break;
+                    sizes[childIndex] = childSize;
+                    sizeToDistribute -= (childSize - previousWidth);
+                    if (reachedMaxSize) {
+                        Clay__ResizableContainerBuffer_RemoveSwapback(resizableContainerBuffer, childIndex--);
                     }
-                    default: break;
                 }
             }
         }
-
-        if (rootElement->layoutConfig->sizing.width.type != CLAY__SIZING_TYPE_PERCENT) {
-            rootElement->dimensions.width = CLAY__MIN(CLAY__MAX(rootElement->dimensions.width, rootElement->layoutConfig->sizing.width.size.minMax.min), rootElement->layoutConfig->sizing.width.size.minMax.max);
+    // Sizing along the non layout axis ("off axis")
+    } else {
+        float maxSize = parentSize - parentPadding;
+        // If we're laying out the children of a scroll panel, grow containers expand to the size of the inner content, not the outer container
+        if (Clay__ElementHasConfig(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP)) {
+            Clay_ClipElementConfig *clipElementConfig = Clay__FindElementConfigWithType(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+            if (((xAxis && clipElementConfig->horizontal) || (!xAxis && clipElementConfig->vertical))) {
+                maxSize = CLAY__MAX(maxSize, innerContentSize);
+            }
         }
-        if (rootElement->layoutConfig->sizing.height.type != CLAY__SIZING_TYPE_PERCENT) {
-            rootElement->dimensions.height = CLAY__MIN(CLAY__MAX(rootElement->dimensions.height, rootElement->layoutConfig->sizing.height.size.minMax.min), rootElement->layoutConfig->sizing.height.size.minMax.max);
+        for (int32_t childOffset = 0; childOffset < resizableContainerCount; childOffset++) {
+            float childSize = sizes[childOffset];
+            if (resizableContainerBuffer->sizingTypes[childOffset] == CLAY__SIZING_TYPE_GROW) {
+                childSize = CLAY__MIN(maxSize, resizableContainerBuffer->maxSizes[childOffset]);
+            }
+            sizes[childOffset] = CLAY__MAX(resizableContainerBuffer->minSizes[childOffset], CLAY__MIN(childSize, maxSize));
         }
+    }
 
-        for (int32_t i = 0; i < bfsBuffer.length; ++i) {
-            int32_t parentIndex = Clay__int32_tArray_GetValue(&bfsBuffer, i);
-            Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&context->layoutElements, parentIndex);
-            Clay_LayoutConfig *parentStyleConfig = parent->layoutConfig;
-            int32_t growContainerCount = 0;
-            float parentSize = xAxis ? parent->dimensions.width : parent->dimensions.height;
-            float parentPadding = (float)(xAxis ? (parent->layoutConfig->padding.left + parent->layoutConfig->padding.right) : (parent->layoutConfig->padding.top + parent->layoutConfig->padding.bottom));
-            float innerContentSize = 0, totalPaddingAndChildGaps = parentPadding;
-            bool sizingAlongAxis = (xAxis && parentStyleConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) || (!xAxis && parentStyleConfig->layoutDirection == CLAY_TOP_TO_BOTTOM);
-            resizableContainerBuffer.length = 0;
-            float parentChildGap = parentStyleConfig->childGap;
+    // Removed entries are kept past the end of the buffer, so this writes back every resizable child
+    for (int32_t childOffset = 0; childOffset < resizableContainerCount; childOffset++) {
+        Clay_LayoutElement *childElement = &context->layoutElements.internalArray[resizableContainerBuffer->elementIndexes[childOffset]];
+        *(xAxis ? &childElement->dimensions.width : &childElement->dimensions.height) = sizes[childOffset];
+    }
+}
 
-            for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
-                int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
-                Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-                float childSize = xAxis ? childElement->dimensions.width : childElement->dimensions.height;
+// Sizes every descendant of an element along one axis, breadth first. The buffers must have room for every element in the subtree.
+void Clay__SizeSubtreeAlongAxis(bool xAxis, int32_t elementIndex, Clay__int32_tArray bfsBuffer, Clay__ResizableContainerBuffer resizableContainerBuffer) {
+    bfsBuffer.length = 0;
+    Clay__int32_tArray_Add(&bfsBuffer, elementIndex);
+    for (int32_t i = 0; i < bfsBuffer.length; ++i) {
+        Clay__SizeChildrenAlongAxis(xAxis, Clay__int32_tArray_GetValue(&bfsBuffer, i), &bfsBuffer, &resizableContainerBuffer);
+    }
+}
 
-                if (!Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) && childElement->childrenOrTextContent.children.length > 0) {
-                    Clay__int32_tArray_Add(&bfsBuffer, childElementIndex);
-                }
+void Clay__SizeContainersAlongAxis(bool xAxis) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        Clay__SizeTreeRoot(root);
+        Clay__SizeSubtreeAlongAxis(xAxis, root->layoutElementIndex, context->layoutElementChildrenBuffer, context->resizableContainerBuffer);
+    }
+}
 
-                if (childSizing.type != CLAY__SIZING_TYPE_PERCENT
-                    && childSizing.type != CLAY__SIZING_TYPE_FIXED
-                    && (!Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || (Clay__FindElementConfigWithType(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig->wrapMode == CLAY_TEXT_WRAP_WORDS)) // todo too many loops
-//                    && (xAxis || !Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT))
-                ) {
-                    Clay__int32_tArray_Add(&resizableContainerBuffer, childElementIndex);
-                }
+#define CLAY__PARALLEL_LAYOUT_MIN_ELEMENTS 1024
+#define CLAY__PARALLEL_LAYOUT_MAX_JOBS 64
 
-                if (sizingAlongAxis) {
-                    innerContentSize += (childSizing.type == CLAY__SIZING_TYPE_PERCENT ? 0 : childSize);
-                    if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
-                        growContainerCount++;
-                    }
-                    if (childOffset > 0) {
-                        innerContentSize += parentChildGap; // For children after index 0, the childAxisOffset is the gap from the previous child
-                        totalPaddingAndChildGaps += parentChildGap;
-                    }
-                } else {
-                    innerContentSize = CLAY__MAX(childSize, innerContentSize);
-                }
-            }
+typedef struct {
+    int32_t firstTask;
+    int32_t endTask;
+    int32_t bufferOffset; // Each job gets its own range of the BFS and resizable container buffers, large enough for all of its subtrees
+    int32_t bufferLength;
+} Clay__ParallelLayoutJob;
 
-            // Expand percentage containers to size
-            for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
-                int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
-                Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-                float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
-                if (childSizing.type == CLAY__SIZING_TYPE_PERCENT) {
-                    *childSize = (parentSize - totalPaddingAndChildGaps) * childSizing.size.percent;
-                    if (sizingAlongAxis) {
-                        innerContentSize += *childSize;
-                    }
-                    Clay__UpdateAspectRatioBox(childElement);
+typedef struct {
+    Clay_Context *context;
+    bool xAxis;
+    int32_t *taskElementIndexes;
+    Clay__ParallelLayoutJob jobs[CLAY__PARALLEL_LAYOUT_MAX_JOBS];
+} Clay__ParallelLayoutJobs;
+
+// Counts the elements in every subtree, and finds the tree each floating root is sized relative to. Returns false if the layout
+// should be sized on the calling thread instead, either because it is too small to be worth splitting up, or because a floating
+// root is sized relative to an element in a later tree, which sequential layout reads before that tree is sized.
+bool Clay__PrepareParallelLayout(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->layoutElements.length < CLAY__PARALLEL_LAYOUT_MIN_ELEMENTS) {
+        return false;
+    }
+    int32_t *treeRootIndexes = context->reusableElementIndexBuffer.internalArray;
+    int32_t *subtreeSizes = context->layoutElementSubtreeSizes.internalArray;
+    Clay__int32_tArray bfsBuffer = context->layoutElementChildrenBuffer;
+    bfsBuffer.length = 0;
+    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        treeRootIndexes[root->layoutElementIndex] = rootIndex;
+        Clay__int32_tArray_Add(&bfsBuffer, root->layoutElementIndex);
+    }
+    for (int32_t i = 0; i < bfsBuffer.length; ++i) {
+        Clay_LayoutElement *element = &context->layoutElements.internalArray[bfsBuffer.internalArray[i]];
+        if (Clay__ElementHasConfig(element, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+            continue;
+        }
+        for (int32_t j = 0; j < element->childrenOrTextContent.children.length; ++j) {
+            int32_t childIndex = element->childrenOrTextContent.children.elements[j];
+            treeRootIndexes[childIndex] = treeRootIndexes[bfsBuffer.internalArray[i]];
+            Clay__int32_tArray_Add(&bfsBuffer, childIndex);
+        }
+    }
+    // Children always come after their parent in BFS order, so walking it backwards counts subtrees bottom up
+    for (int32_t i = bfsBuffer.length - 1; i >= 0; --i) {
+        Clay_LayoutElement *element = &context->layoutElements.internalArray[bfsBuffer.internalArray[i]];
+        int32_t subtreeSize = 1;
+        if (!Clay__ElementHasConfig(element, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+            for (int32_t j = 0; j < element->childrenOrTextContent.children.length; ++j) {
+                subtreeSize += subtreeSizes[element->childrenOrTextContent.children.elements[j]];
+            }
+        }
+        subtreeSizes[bfsBuffer.internalArray[i]] = subtreeSize;
+    }
+    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, root->layoutElementIndex);
+        root->parentRootIndex = -1;
+        if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
+            Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig->parentId);
+            int32_t parentElementIndex = parentItem->layoutElement ? (int32_t)(parentItem->layoutElement - context->layoutElements.internalArray) : -1;
+            if (parentElementIndex >= 0 && parentElementIndex < context->layoutElements.length) {
+                root->parentRootIndex = treeRootIndexes[parentElementIndex];
+                if (root->parentRootIndex > rootIndex) {
+                    return false;
                 }
             }
+        }
+    }
+    return true;
+}
 
-            if (sizingAlongAxis) {
-                float sizeToDistribute = parentSize - parentPadding - innerContentSize;
-                // The content is too large, compress the children as much as possible
-                if (sizeToDistribute < 0) {
-                    // If the parent clips content in this axis direction, don't compress children, just leave them alone
-                    Clay_ClipElementConfig *clipElementConfig = Clay__FindElementConfigWithType(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
-                    if (clipElementConfig) {
-                        if (((xAxis && clipElementConfig->horizontal) || (!xAxis && clipElementConfig->vertical))) {
-                            continue;
-                        }
-                    }
-                    // Scrolling containers preferentially compress before others
-                    while (sizeToDistribute < -CLAY__EPSILON && resizableContainerBuffer.length > 0) {
-                        float largest = 0;
-                        float secondLargest = 0;
-                        float widthToAdd = sizeToDistribute;
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float childSize = xAxis ? child->dimensions.width : child->dimensions.height;
-                            if (Clay__FloatEqual(childSize, largest)) { continue; }
-                            if (childSize > largest) {
-                                secondLargest = largest;
-                                largest = childSize;
-                            }
-                            if (childSize < largest) {
-                                secondLargest = CLAY__MAX(secondLargest, childSize);
-                                widthToAdd = secondLargest - largest;
-                            }
-                        }
+void Clay__RunParallelLayoutJob(int32_t jobIndex, void *jobData) {
+    Clay__ParallelLayoutJobs *jobs = (Clay__ParallelLayoutJobs *)jobData;
+    Clay_Context* context = jobs->context;
+    // Jobs may run on a thread with a different current context, which is restored afterwards in case the thread runs its own layouts
+    Clay_Context* previousContext = Clay_GetCurrentContext();
+    if (previousContext != context) {
+        Clay_SetCurrentContext(context);
+    }
+    Clay__ParallelLayoutJob *job = &jobs->jobs[jobIndex];
+    Clay__int32_tArray bfsBuffer = { .capacity = job->bufferLength, .length = 0, .internalArray = context->layoutElementChildrenBuffer.internalArray + job->bufferOffset };
+    Clay__ResizableContainerBuffer resizableContainerBuffer = Clay__ResizableContainerBuffer_Slice(&context->resizableContainerBuffer, job->bufferOffset, job->bufferLength);
+    for (int32_t taskIndex = job->firstTask; taskIndex < job->endTask; ++taskIndex) {
+        Clay__SizeSubtreeAlongAxis(jobs->xAxis, jobs->taskElementIndexes[taskIndex], bfsBuffer, resizableContainerBuffer);
+    }
+    if (previousContext != context) {
+        Clay_SetCurrentContext(previousContext);
+    }
+}
 
-                        widthToAdd = CLAY__MAX(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
-
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float *childSize = xAxis ? &child->dimensions.width : &child->dimensions.height;
-                            float minSize = xAxis ? child->minDimensions.width : child->minDimensions.height;
-                            float previousWidth = *childSize;
-                            if (Clay__FloatEqual(*childSize, largest)) {
-                                *childSize += widthToAdd;
-                                if (*childSize <= minSize) {
-                                    *childSize = minSize;
-                                    Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                                }
-                                sizeToDistribute -= (*childSize - previousWidth);
-                            }
-                        }
-                    }
-                // The content is too small, allow SIZING_GROW containers to expand
-                } else if (sizeToDistribute > 0 && growContainerCount > 0) {
-                    for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                        Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                        Clay__SizingType childSizing = xAxis ? child->layoutConfig->sizing.width.type : child->layoutConfig->sizing.height.type;
-                        if (childSizing != CLAY__SIZING_TYPE_GROW) {
-                            Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                        }
-                    }
-                    while (sizeToDistribute > CLAY__EPSILON && resizableContainerBuffer.length > 0) {
-                        float smallest = CLAY__MAXFLOAT;
-                        float secondSmallest = CLAY__MAXFLOAT;
-                        float widthToAdd = sizeToDistribute;
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float childSize = xAxis ? child->dimensions.width : child->dimensions.height;
-                            if (Clay__FloatEqual(childSize, smallest)) { continue; }
-                            if (childSize < smallest) {
-                                secondSmallest = smallest;
-                                smallest = childSize;
-                            }
-                            if (childSize > smallest) {
-                                secondSmallest = CLAY__MIN(secondSmallest, childSize);
-                                widthToAdd = secondSmallest - smallest;
-                            }
-                        }
+// Sizes a run of tree roots that don't depend on each other. The top of any subtree that is too large to balance across jobs
+// is sized on the calling thread, then the remaining subtrees are split between jobs.
+void Clay__SizeTreeRootsAlongAxisInParallel(bool xAxis, int32_t firstRootIndex, int32_t endRootIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t *subtreeSizes = context->layoutElementSubtreeSizes.internalArray;
+    Clay__int32_tArray tasks = context->reusableElementIndexBuffer;
+    tasks.length = 0;
+    int32_t elementCount = 0;
+    for (int32_t rootIndex = firstRootIndex; rootIndex < endRootIndex; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        Clay__SizeTreeRoot(root);
+        Clay__int32_tArray_Add(&tasks, root->layoutElementIndex);
+        elementCount += subtreeSizes[root->layoutElementIndex];
+    }
+    if (elementCount < CLAY__PARALLEL_LAYOUT_MIN_ELEMENTS) {
+        for (int32_t i = 0; i < tasks.length; ++i) {
+            Clay__SizeSubtreeAlongAxis(xAxis, tasks.internalArray[i], context->layoutElementChildrenBuffer, context->resizableContainerBuffer);
+        }
+        return;
+    }
+    int32_t splitThreshold = elementCount / CLAY__PARALLEL_LAYOUT_MAX_JOBS;
+    int32_t taskCount = 0;
+    int32_t taskElementCount = 0;
+    for (int32_t i = 0; i < tasks.length; ++i) {
+        int32_t elementIndex = tasks.internalArray[i];
+        if (subtreeSizes[elementIndex] > splitThreshold) {
+            // Children with children of their own are appended to the task list
+            Clay__SizeChildrenAlongAxis(xAxis, elementIndex, &tasks, &context->resizableContainerBuffer);
+        } else {
+            tasks.internalArray[taskCount++] = elementIndex;
+            taskElementCount += subtreeSizes[elementIndex];
+        }
+    }
+    if (taskCount == 0) {
+        return;
+    }
+    Clay__ParallelLayoutJobs jobs = { .context = context, .xAxis = xAxis, .taskElementIndexes = tasks.internalArray };
+    int32_t jobCount = CLAY__MIN(taskCount, CLAY__PARALLEL_LAYOUT_MAX_JOBS);
+    int32_t taskIndex = 0;
+    int32_t bufferOffset = 0;
+    for (int32_t jobIndex = 0; jobIndex < jobCount; ++jobIndex) {
+        // Contiguous runs of tasks with roughly equal element counts
+        int64_t targetBufferEnd = (int64_t)taskElementCount * (jobIndex + 1) / jobCount;
+        Clay__ParallelLayoutJob *job = &jobs.jobs[jobIndex];
+        job->firstTask = taskIndex;
+        job->bufferOffset = bufferOffset;
+        while (taskIndex < taskCount && (taskIndex == job->firstTask || bufferOffset < targetBufferEnd || jobIndex == jobCount - 1)) {
+            bufferOffset += subtreeSizes[tasks.internalArray[taskIndex]];
+            taskIndex++;
+        }
+        job->endTask = taskIndex;
+        job->bufferLength = bufferOffset - job->bufferOffset;
+    }
+    context->layoutJobFunction(Clay__RunParallelLayoutJob, &jobs, jobCount, context->layoutJobUserData);
+}
 
-                        widthToAdd = CLAY__MIN(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
-
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float *childSize = xAxis ? &child->dimensions.width : &child->dimensions.height;
-                            float maxSize = xAxis ? child->layoutConfig->sizing.width.size.minMax.max : child->layoutConfig->sizing.height.size.minMax.max;
-                            float previousWidth = *childSize;
-                            if (Clay__FloatEqual(*childSize, smallest)) {
-                                *childSize += widthToAdd;
-                                if (*childSize >= maxSize) {
-                                    *childSize = maxSize;
-                                    Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                                }
-                                sizeToDistribute -= (*childSize - previousWidth);
-                            }
-                        }
-                    }
-                }
-            // Sizing along the non layout axis ("off axis")
-            } else {
-                for (int32_t childOffset = 0; childOffset < resizableContainerBuffer.length; childOffset++) {
-                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childOffset));
-                    Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-                    float minSize = xAxis ? childElement->minDimensions.width : childElement->minDimensions.height;
-                    float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
-
-                    float maxSize = parentSize - parentPadding;
-                    // If we're laying out the children of a scroll panel, grow containers expand to the size of the inner content, not the outer container
-                    if (Clay__ElementHasConfig(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP)) {
-                        Clay_ClipElementConfig *clipElementConfig = Clay__FindElementConfigWithType(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
-                        if (((xAxis && clipElementConfig->horizontal) || (!xAxis && clipElementConfig->vertical))) {
-                            maxSize = CLAY__MAX(maxSize, innerContentSize);
-                        }
-                    }
-                    if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
-                        *childSize = CLAY__MIN(maxSize, childSizing.size.minMax.max);
-                    }
-                    *childSize = CLAY__MAX(minSize, CLAY__MIN(*childSize, maxSize));
-                }
-            }
+// Equivalent to Clay__SizeContainersAlongAxis, but roots are sized in runs that only depend on trees from earlier runs
+void Clay__SizeContainersAlongAxisInParallel(bool xAxis) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t firstRootIndex = 0;
+    for (int32_t rootIndex = 1; rootIndex <= context->layoutElementTreeRoots.length; ++rootIndex) {
+        if (rootIndex == context->layoutElementTreeRoots.length || Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex)->parentRootIndex >= firstRootIndex) {
+            Clay__SizeTreeRootsAlongAxisInParallel(xAxis, firstRootIndex, rootIndex);
+            firstRootIndex = rootIndex;
         }
     }
 }
@@ -2475,6 +4137,10 @@ Clay_String Clay__IntToString(int32_t integer) {
         return CLAY__INIT(Clay_String) { .length = 1, .chars = "0" };
     }
     Clay_Context* context = Clay_GetCurrentContext();
+    // Enough for any int32_t, including the sign
+    if (context->dynamicStringData.length + 11 > context->dynamicStringData.capacity && !Clay__GrowArrayToFit(context, &context->dynamicStringData.capacity, context->dynamicStringData.length + 11)) {
+        return CLAY__INIT(Clay_String) { .length = 1, .chars = "?" };
+    }
     char *chars = (char *)(context->dynamicStringData.internalArray + context->dynamicStringData.length);
     int32_t length = 0;
     int32_t sign = integer;
@@ -2503,7 +4169,7 @@ Clay_String Clay__IntToString(int32_t integer) {
 
 void Clay__AddRenderCommand(Clay_RenderCommand renderCommand) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->renderCommands.length < context->renderCommands.capacity - 1) {
+    if (context->renderCommands.length < context->renderCommands.capacity - 1 || Clay__GrowElementArrays(context)) {
         Clay_RenderCommandArray_Add(&context->renderCommands, renderCommand);
     } else {
         if (!context->booleanWarnings.maxRenderCommandsExceeded) {
@@ -2516,24 +4182,186 @@ void Clay__AddRenderCommand(Clay_RenderCommand renderCommand) {
     }
 }
 
-bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
+bool Clay__ElementIsOutsideRect(Clay_BoundingBox *boundingBox, Clay_BoundingBox *rect) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->disableCulling) {
         return false;
     }
 
-    return (boundingBox->x > (float)context->layoutDimensions.width) ||
-           (boundingBox->y > (float)context->layoutDimensions.height) ||
-           (boundingBox->x + boundingBox->width < 0) ||
-           (boundingBox->y + boundingBox->height < 0);
+    return (boundingBox->x > rect->x + rect->width) ||
+           (boundingBox->y > rect->y + rect->height) ||
+           (boundingBox->x + boundingBox->width < rect->x) ||
+           (boundingBox->y + boundingBox->height < rect->y);
+}
+
+bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_BoundingBox screen = { 0, 0, context->layoutDimensions.width, context->layoutDimensions.height };
+    return Clay__ElementIsOutsideRect(boundingBox, &screen);
+}
+
+// Counts the elements in every subtree, and finds the elements whose descendants can't be drawn outside their bounding box,
+// either because they fit inside it or because it clips them. If such an element is culled, its whole subtree can be skipped.
+void Clay__CalculateSubtreeContainment(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t *subtreeSizes = context->layoutElementSubtreeSizes.internalArray;
+    bool *contained = context->layoutElementSubtreeContained.internalArray;
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        contained[i] = true;
+    }
+    // Floating elements are positioned relative to the bounding box of their parent, which must be calculated even if it's offscreen
+    for (int32_t i = 0; i < context->layoutElementTreeRoots.length; ++i) {
+        Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(context->layoutElementTreeRoots.internalArray[i].parentId);
+        int32_t parentIndex = parentItem->layoutElement ? (int32_t)(parentItem->layoutElement - context->layoutElements.internalArray) : -1;
+        if (parentIndex >= 0 && parentIndex < context->layoutElements.length) {
+            contained[parentIndex] = false;
+        }
+    }
+    // Children are always declared after their parent, so visiting elements in reverse order visits every child before its parent
+    for (int32_t i = context->layoutElements.length - 1; i >= 0; --i) {
+        Clay_LayoutElement *element = &context->layoutElements.internalArray[i];
+        subtreeSizes[i] = 1;
+        if (Clay__ElementHasConfig(element, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+            // A word that can't be wrapped is drawn past the edge of a text element that is narrower than it
+            Clay__WrappedTextLineArraySlice wrappedLines = element->childrenOrTextContent.textElementData->wrappedLines;
+            for (int32_t j = 0; j < wrappedLines.length; ++j) {
+                if (wrappedLines.internalArray[j].dimensions.width > element->dimensions.width + CLAY__EPSILON) {
+                    contained[i] = false;
+                    break;
+                }
+            }
+            continue;
+        }
+        // Elements left open after running out of capacity never had their children attached
+        if (element->childrenOrTextContent.children.elements == NULL) {
+            contained[i] = false;
+            continue;
+        }
+        Clay_LayoutConfig *layoutConfig = element->layoutConfig;
+        Clay_Dimensions contentSize = { (float)(layoutConfig->padding.left + layoutConfig->padding.right), (float)(layoutConfig->padding.top + layoutConfig->padding.bottom) };
+        Clay_Dimensions largestChild = CLAY__DEFAULT_STRUCT;
+        for (int32_t j = 0; j < element->childrenOrTextContent.children.length; ++j) {
+            int32_t childIndex = element->childrenOrTextContent.children.elements[j];
+            Clay_LayoutElement *childElement = &context->layoutElements.internalArray[childIndex];
+            subtreeSizes[i] += subtreeSizes[childIndex];
+            contained[i] = contained[i] && contained[childIndex];
+            if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
+                contentSize.width += childElement->dimensions.width + (float)(j > 0 ? layoutConfig->childGap : 0);
+                largestChild.height = CLAY__MAX(largestChild.height, childElement->dimensions.height);
+            } else {
+                contentSize.height += childElement->dimensions.height + (float)(j > 0 ? layoutConfig->childGap : 0);
+                largestChild.width = CLAY__MAX(largestChild.width, childElement->dimensions.width);
+            }
+        }
+        contentSize.width += largestChild.width;
+        contentSize.height += largestChild.height;
+        Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(element, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+        Clay_Vector2 childOffset = clipConfig && !context->externalScrollHandlingEnabled ? clipConfig->childOffset : CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
+        bool containedX = (clipConfig && clipConfig->horizontal) || (childOffset.x == 0 && contentSize.width <= element->dimensions.width + CLAY__EPSILON);
+        bool containedY = (clipConfig && clipConfig->vertical) || (childOffset.y == 0 && contentSize.height <= element->dimensions.height + CLAY__EPSILON);
+        contained[i] = contained[i] && containedX && containedY;
+    }
+}
+
+// Stable sort of the tree roots by z-index, so that roots with equal z-index stay in declaration order
+void Clay__SortLayoutElementTreeRoots(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementTreeRoot *roots = context->layoutElementTreeRoots.internalArray;
+    int32_t rootCount = context->layoutElementTreeRoots.length;
+    bool sorted = true;
+    for (int32_t i = 1; i < rootCount; ++i) {
+        if (roots[i].zIndex < roots[i - 1].zIndex) {
+            sorted = false;
+            break;
+        }
+    }
+    if (sorted) {
+        return;
+    }
+    // Two pass LSD radix sort of root indexes on the 16 bit z-index, flipping the sign bit so that negative z-indexes sort first.
+    // Both index buffers are free at this point in the layout.
+    int32_t *sortedIndexes = context->reusableElementIndexBuffer.internalArray;
+    int32_t *scratchIndexes = context->layoutElementChildrenBuffer.internalArray;
+    for (int32_t i = 0; i < rootCount; ++i) {
+        scratchIndexes[i] = i;
+    }
+    for (int32_t shift = 0; shift <= 8; shift += 8) {
+        int32_t *source = shift == 0 ? scratchIndexes : sortedIndexes;
+        int32_t *destination = shift == 0 ? sortedIndexes : scratchIndexes;
+        int32_t bucketOffsets[256] = CLAY__DEFAULT_STRUCT;
+        for (int32_t i = 0; i < rootCount; ++i) {
+            bucketOffsets[(((uint16_t)roots[i].zIndex ^ 0x8000) >> shift) & 0xFF]++;
+        }
+        int32_t total = 0;
+        for (int32_t bucket = 0; bucket < 256; ++bucket) {
+            int32_t count = bucketOffsets[bucket];
+            bucketOffsets[bucket] = total;
+            total += count;
+        }
+        for (int32_t i = 0; i < rootCount; ++i) {
+            int32_t rootIndex = source[i];
+            destination[bucketOffsets[(((uint16_t)roots[rootIndex].zIndex ^ 0x8000) >> shift) & 0xFF]++] = rootIndex;
+        }
+    }
+    // Apply the permutation in place by following each cycle, marking finished positions as they are written
+    for (int32_t i = 0; i < rootCount; ++i) {
+        if (scratchIndexes[i] == i) {
+            continue;
+        }
+        Clay__LayoutElementTreeRoot first = roots[i];
+        int32_t current = i;
+        while (scratchIndexes[current] != i) {
+            int32_t next = scratchIndexes[current];
+            roots[current] = roots[next];
+            scratchIndexes[current] = current;
+            current = next;
+        }
+        roots[current] = first;
+        scratchIndexes[current] = current;
+    }
+}
+
+// Called once all of an element's children have their subtree bounds, to union them into the element's own
+void Clay__UpdateSubtreeHitTestBounds(Clay_LayoutElement *layoutElement) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__ElementHitTestBounds *bounds = &context->layoutElementHitTestBounds.internalArray[layoutElement - context->layoutElements.internalArray];
+    bounds->subtreeMin = CLAY__INIT(Clay_Vector2) { bounds->boundingBox.x, bounds->boundingBox.y };
+    bounds->subtreeMax = CLAY__INIT(Clay_Vector2) { bounds->boundingBox.x + bounds->boundingBox.width, bounds->boundingBox.y + bounds->boundingBox.height };
+    bounds->childrenOrdered = true;
+    if (bounds->subtreeCulled || Clay__ElementHasConfig(layoutElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+        return;
+    }
+    bool horizontal = layoutElement->layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT;
+    float previousChildEnd = 0;
+    for (int32_t i = 0; i < layoutElement->childrenOrTextContent.children.length; ++i) {
+        Clay__ElementHitTestBounds *childBounds = &context->layoutElementHitTestBounds.internalArray[layoutElement->childrenOrTextContent.children.elements[i]];
+        bounds->subtreeMin.x = CLAY__MIN(bounds->subtreeMin.x, childBounds->subtreeMin.x);
+        bounds->subtreeMin.y = CLAY__MIN(bounds->subtreeMin.y, childBounds->subtreeMin.y);
+        bounds->subtreeMax.x = CLAY__MAX(bounds->subtreeMax.x, childBounds->subtreeMax.x);
+        bounds->subtreeMax.y = CLAY__MAX(bounds->subtreeMax.y, childBounds->subtreeMax.y);
+        float childStart = horizontal ? childBounds->subtreeMin.x : childBounds->subtreeMin.y;
+        float childEnd = horizontal ? childBounds->subtreeMax.x : childBounds->subtreeMax.y;
+        if ((i > 0 && childStart < previousChildEnd) || childEnd < childStart) {
+            bounds->childrenOrdered = false;
+        }
+        previousChildEnd = childEnd;
+    }
 }
 
 void Clay__CalculateFinalLayout(void) {
     Clay_Context* context = Clay_GetCurrentContext();
+    CLAY_PROFILE_BEGIN(CLAY_PROFILE_PHASE_SIZE_X);
+    bool sizeInParallel = context->layoutJobFunction && Clay__PrepareParallelLayout();
     // Calculate sizing along the X axis
-    Clay__SizeContainersAlongAxis(true);
+    if (sizeInParallel) {
+        Clay__SizeContainersAlongAxisInParallel(true);
+    } else {
+        Clay__SizeContainersAlongAxis(true);
+    }
+    CLAY_PROFILE_END(CLAY_PROFILE_PHASE_SIZE_X, context->layoutElements.length);
 
     // Wrap text
+    CLAY_PROFILE_BEGIN(CLAY_PROFILE_PHASE_WRAP_TEXT);
     for (int32_t textElementIndex = 0; textElementIndex < context->textElementData.length; ++textElementIndex) {
         Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&context->textElementData, textElementIndex);
         textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &context->wrappedTextLines.internalArray[context->wrappedTextLines.length] };
@@ -2549,13 +4377,31 @@ void Clay__CalculateFinalLayout(void) {
             textElementData->wrappedLines.length++;
             continue;
         }
-        float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, textConfig, context->measureTextUserData).width;
+        // Measurements in the shared cache are read only, so only the context's own can hold wrapped lines
+        bool cacheWrappedLines = !measureTextCacheItem->inSharedCache && measureTextCacheItem != &Clay__MeasureTextCacheItem_DEFAULT;
+        if (cacheWrappedLines && measureTextCacheItem->wrappedLineCount > 0 && measureTextCacheItem->wrappedWidth == containerElement->dimensions.width) {
+            int32_t lineIndex = measureTextCacheItem->wrappedLinesStartIndex;
+            for (int32_t i = 0; i < measureTextCacheItem->wrappedLineCount; ++i) {
+                if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 1 && !Clay__GrowElementArrays(context)) {
+                    break;
+                }
+                Clay__CachedWrappedLine *line = Clay__CachedWrappedLineArray_Get(&context->cachedWrappedLines, lineIndex);
+                Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { line->width, lineHeight }, { .length = line->length, .chars = &textElementData->text.chars[line->startOffset] } });
+                textElementData->wrappedLines.length++;
+                lineIndex = line->next;
+            }
+            containerElement->dimensions.height = lineHeight * (float)textElementData->wrappedLines.length;
+            continue;
+        }
+        bool wrappedLinesExceeded = false;
+        float spaceWidth = measureTextCacheItem->spaceWidth;
         int32_t wordIndex = measureTextCacheItem->measuredWordsStartIndex;
         while (wordIndex != -1) {
-            if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 1) {
+            if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 1 && !Clay__GrowElementArrays(context)) {
+                wrappedLinesExceeded = true;
                 break;
             }
-            Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
+            Clay__MeasuredWord *measuredWord = Clay__GetMeasuredWord(measureTextCacheItem, wordIndex);
             // Only word on the line is too large, just render it anyway
             if (lineLengthChars == 0 && lineWidth + measuredWord->width > containerElement->dimensions.width) {
                 Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { measuredWord->width, lineHeight }, { .length = measuredWord->length, .chars = &textElementData->text.chars[measuredWord->startOffset] } });
@@ -2585,10 +4431,15 @@ void Clay__CalculateFinalLayout(void) {
             Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth - textConfig->letterSpacing, lineHeight }, {.length = lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
             textElementData->wrappedLines.length++;
         }
+        if (cacheWrappedLines && !wrappedLinesExceeded) {
+            Clay__CacheWrappedLines(measureTextCacheItem, textElementData->wrappedLines, textElementData->text.chars, containerElement->dimensions.width);
+        }
         containerElement->dimensions.height = lineHeight * (float)textElementData->wrappedLines.length;
     }
+    CLAY_PROFILE_END(CLAY_PROFILE_PHASE_WRAP_TEXT, context->textElementData.length);
 
     // Scale vertical heights according to aspect ratio
+    CLAY_PROFILE_BEGIN(CLAY_PROFILE_PHASE_SIZE_Y);
     for (int32_t i = 0; i < context->aspectRatioElementIndexes.length; ++i) {
         Clay_LayoutElement* aspectElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&context->aspectRatioElementIndexes, i));
         Clay_AspectRatioElementConfig *config = Clay__FindElementConfigWithType(aspectElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT).aspectRatioElementConfig;
@@ -2645,7 +4496,11 @@ void Clay__CalculateFinalLayout(void) {
     }
 
     // Calculate sizing along the Y axis
-    Clay__SizeContainersAlongAxis(false);
+    if (sizeInParallel) {
+        Clay__SizeContainersAlongAxisInParallel(false);
+    } else {
+        Clay__SizeContainersAlongAxis(false);
+    }
 
     // Scale horizontal widths according to aspect ratio
     for (int32_t i = 0; i < context->aspectRatioElementIndexes.length; ++i) {
@@ -2653,29 +4508,28 @@ void Clay__CalculateFinalLayout(void) {
         Clay_AspectRatioElementConfig *config = Clay__FindElementConfigWithType(aspectElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT).aspectRatioElementConfig;
         aspectElement->dimensions.width = config->aspectRatio * aspectElement->dimensions.height;
     }
+    CLAY_PROFILE_END(CLAY_PROFILE_PHASE_SIZE_Y, context->layoutElements.length);
 
     // Sort tree roots by z-index
-    int32_t sortMax = context->layoutElementTreeRoots.length - 1;
-    while (sortMax > 0) { // todo dumb bubble sort
-        for (int32_t i = 0; i < sortMax; ++i) {
-            Clay__LayoutElementTreeRoot current = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
-            Clay__LayoutElementTreeRoot next = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i + 1);
-            if (next.zIndex < current.zIndex) {
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i, next);
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i + 1, current);
-            }
-        }
-        sortMax--;
-    }
+    CLAY_PROFILE_BEGIN(CLAY_PROFILE_PHASE_SORT_Z);
+    Clay__SortLayoutElementTreeRoots();
+    CLAY_PROFILE_END(CLAY_PROFILE_PHASE_SORT_Z, context->layoutElementTreeRoots.length);
 
     // Calculate final positions and generate render commands
+    CLAY_PROFILE_BEGIN(CLAY_PROFILE_PHASE_RENDER_COMMANDS);
     context->renderCommands.length = 0;
+    context->cullingStats = CLAY__INIT(Clay_CullingStats) CLAY__DEFAULT_STRUCT;
+    bool subtreeCullingEnabled = context->subtreeCullingEnabled && !context->disableCulling;
+    if (subtreeCullingEnabled) {
+        Clay__CalculateSubtreeContainment();
+    }
     dfsBuffer.length = 0;
     for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
         dfsBuffer.length = 0;
         Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
         Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
         Clay_Vector2 rootPosition = CLAY__DEFAULT_STRUCT;
+        Clay_BoundingBox rootCullRect = { 0, 0, context->layoutDimensions.width, context->layoutDimensions.height };
         Clay_LayoutElementHashMapItem *parentHashMapItem = Clay__GetHashMapItem(root->parentId);
         // Position root floating containers
         if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING) && parentHashMapItem) {
@@ -2744,6 +4598,8 @@ void Clay__CalculateFinalLayout(void) {
                     if (clipConfig->vertical) {
                         rootPosition.y += clipConfig->childOffset.y;
                     }
+                } else {
+                    rootCullRect = Clay__IntersectBoundingBoxes(rootCullRect, clipHashMapItem->boundingBox);
                 }
                 Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
                     .boundingBox = clipHashMapItem->boundingBox,
@@ -2754,7 +4610,7 @@ void Clay__CalculateFinalLayout(void) {
                 });
             }
         }
-        Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = rootElement, .position = rootPosition, .nextChildOffset = { .x = (float)rootElement->layoutConfig->padding.left, .y = (float)rootElement->layoutConfig->padding.top } });
+        Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = rootElement, .position = rootPosition, .nextChildOffset = { .x = (float)rootElement->layoutConfig->padding.left, .y = (float)rootElement->layoutConfig->padding.top }, .cullRect = rootCullRect });
 
         context->treeNodeVisited.internalArray[0] = false;
         while (dfsBuffer.length > 0) {
@@ -2762,6 +4618,8 @@ void Clay__CalculateFinalLayout(void) {
             Clay_LayoutElement *currentElement = currentElementTreeNode->layoutElement;
             Clay_LayoutConfig *layoutConfig = currentElement->layoutConfig;
             Clay_Vector2 scrollOffset = CLAY__DEFAULT_STRUCT;
+            int32_t currentElementIndex = (int32_t)(currentElement - context->layoutElements.internalArray);
+            bool cullSubtree = false;
 
             // This will only be run a single time for each element in downwards DFS order
             if (!context->treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
@@ -2777,10 +4635,31 @@ void Clay__CalculateFinalLayout(void) {
                     currentElementBoundingBox.height += expand.height * 2;
                 }
 
+                // Culling - Don't bother to generate render commands for elements entirely outside the screen or their clip region. If none of
+                // the element's descendants can be drawn outside it either, and subtree culling is enabled, they don't need to be visited at all
+                bool offscreen = Clay__ElementIsOutsideRect(&currentElementBoundingBox, &currentElementTreeNode->cullRect);
+                currentElementTreeNode->offscreen = offscreen;
+                if (offscreen) {
+                    context->cullingStats.culledElementCount++;
+                    cullSubtree = subtreeCullingEnabled && context->layoutElementSubtreeContained.internalArray[currentElementIndex] && context->layoutElementSubtreeSizes.internalArray[currentElementIndex] > 1;
+                }
+
                 Clay__ScrollContainerDataInternal *scrollContainerData = CLAY__NULL;
                 // Apply scroll offsets to container
                 if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP)) {
                     Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+                    // Children are only visible inside the clipped axes of this element
+                    if (!context->externalScrollHandlingEnabled) {
+                        Clay_BoundingBox clipRect = Clay__IntersectBoundingBoxes(currentElementTreeNode->cullRect, currentElementBoundingBox);
+                        if (clipConfig->horizontal) {
+                            currentElementTreeNode->cullRect.x = clipRect.x;
+                            currentElementTreeNode->cullRect.width = clipRect.width;
+                        }
+                        if (clipConfig->vertical) {
+                            currentElementTreeNode->cullRect.y = clipRect.y;
+                            currentElementTreeNode->cullRect.height = clipRect.height;
+                        }
+                    }
 
                     // This linear scan could theoretically be slow under very strange conditions, but I can't imagine a real UI with more than a few 10's of scroll containers
                     for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
@@ -2801,24 +4680,20 @@ void Clay__CalculateFinalLayout(void) {
                 if (hashMapItem) {
                     hashMapItem->boundingBox = currentElementBoundingBox;
                 }
+                context->layoutElementHitTestBounds.internalArray[currentElementIndex].boundingBox = currentElementBoundingBox;
+                context->layoutElementHitTestBounds.internalArray[currentElementIndex].subtreeCulled = cullSubtree;
 
+                // Stable partition of the configs - clip configs first so the scissor starts before the element's content, border configs last
                 int32_t sortedConfigIndexes[20];
-                for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
-                    sortedConfigIndexes[elementConfigIndex] = elementConfigIndex;
-                }
-                sortMax = currentElement->elementConfigs.length - 1;
-                while (sortMax > 0) { // todo dumb bubble sort
-                    for (int32_t i = 0; i < sortMax; ++i) {
-                        int32_t current = sortedConfigIndexes[i];
-                        int32_t next = sortedConfigIndexes[i + 1];
-                        Clay__ElementConfigType currentType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, current)->type;
-                        Clay__ElementConfigType nextType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, next)->type;
-                        if (nextType == CLAY__ELEMENT_CONFIG_TYPE_CLIP || currentType == CLAY__ELEMENT_CONFIG_TYPE_BORDER) {
-                            sortedConfigIndexes[i] = next;
-                            sortedConfigIndexes[i + 1] = current;
+                int32_t sortedConfigCount = 0;
+                for (int32_t pass = 0; pass < 3; ++pass) {
+                    for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
+                        Clay__ElementConfigType type = currentElement->elementConfigs.internalArray[elementConfigIndex].type;
+                        int32_t configPass = type == CLAY__ELEMENT_CONFIG_TYPE_CLIP ? 0 : type == CLAY__ELEMENT_CONFIG_TYPE_BORDER ? 2 : 1;
+                        if (configPass == pass) {
+                            sortedConfigIndexes[sortedConfigCount++] = elementConfigIndex;
                         }
                     }
-                    sortMax--;
                 }
 
                 bool emitRectangle = false;
@@ -2839,8 +4714,6 @@ void Clay__CalculateFinalLayout(void) {
                         .id = currentElement->id,
                     };
 
-                    bool offscreen = Clay__ElementIsOffscreen(&currentElementBoundingBox);
-                    // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
                     bool shouldRender = !offscreen;
                     switch (elementConfig->type) {
                         case CLAY__ELEMENT_CONFIG_TYPE_ASPECT:
@@ -2874,6 +4747,7 @@ void Clay__CalculateFinalLayout(void) {
                         }
                         case CLAY__ELEMENT_CONFIG_TYPE_TEXT: {
                             if (!shouldRender) {
+                                context->cullingStats.culledRenderCommandCount += currentElement->childrenOrTextContent.textElementData->wrappedLines.length;
                                 break;
                             }
                             shouldRender = false;
@@ -2896,8 +4770,19 @@ void Clay__CalculateFinalLayout(void) {
                                 if (textElementConfig->textAlignment == CLAY_TEXT_ALIGN_CENTER) {
                                     offset /= 2;
                                 }
+                                Clay_BoundingBox lineBoundingBox = { currentElementBoundingBox.x + offset, currentElementBoundingBox.y + yPosition, wrappedLine->dimensions.width, wrappedLine->dimensions.height };
+                                if (Clay__ElementIsOutsideRect(&lineBoundingBox, &currentElementTreeNode->cullRect)) {
+                                    // Lines below the visible region are followed by more lines below it
+                                    if (lineBoundingBox.y > currentElementTreeNode->cullRect.y + currentElementTreeNode->cullRect.height) {
+                                        context->cullingStats.culledRenderCommandCount += currentElement->childrenOrTextContent.textElementData->wrappedLines.length - lineIndex;
+                                        break;
+                                    }
+                                    context->cullingStats.culledRenderCommandCount++;
+                                    yPosition += finalLineHeight;
+                                    continue;
+                                }
                                 Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                                    .boundingBox = { currentElementBoundingBox.x + offset, currentElementBoundingBox.y + yPosition, wrappedLine->dimensions.width, wrappedLine->dimensions.height },
+                                    .boundingBox = lineBoundingBox,
                                     .renderData = { .text = {
                                         .stringContents = CLAY__INIT(Clay_StringSlice) { .length = wrappedLine->line.length, .chars = wrappedLine->line.chars, .baseChars = currentElement->childrenOrTextContent.textElementData->text.chars },
                                         .textColor = textElementConfig->textColor,
@@ -2912,10 +4797,6 @@ void Clay__CalculateFinalLayout(void) {
                                     .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT,
                                 });
                                 yPosition += finalLineHeight;
-
-                                if (!context->disableCulling && (currentElementBoundingBox.y + yPosition > context->layoutDimensions.height)) {
-                                    break;
-                                }
                             }
                             break;
                         }
@@ -2935,15 +4816,19 @@ void Clay__CalculateFinalLayout(void) {
                     }
                     if (shouldRender) {
                         Clay__AddRenderCommand(renderCommand);
-                    }
-                    if (offscreen) {
-                        // NOTE: You may be tempted to try an early return / continue if an element is off screen. Why bother calculating layout for its children, right?
-                        // Unfortunately, a FLOATING_CONTAINER may be defined that attaches to a child or grandchild of this element, which is large enough to still
-                        // be on screen, even if this element isn't. That depends on this element and it's children being laid out correctly (even if they are entirely off screen)
+                    } else if (offscreen) {
+                        switch (elementConfig->type) {
+                            case CLAY__ELEMENT_CONFIG_TYPE_CLIP: context->cullingStats.culledRenderCommandCount += 2; break; // The scissor start and end
+                            case CLAY__ELEMENT_CONFIG_TYPE_IMAGE:
+                            case CLAY__ELEMENT_CONFIG_TYPE_CUSTOM: context->cullingStats.culledRenderCommandCount++; break;
+                            default: break;
+                        }
                     }
                 }
 
-                if (emitRectangle) {
+                if (emitRectangle && offscreen) {
+                    context->cullingStats.culledRenderCommandCount++;
+                } else if (emitRectangle) {
                     Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
                         .boundingBox = currentElementBoundingBox,
                         .renderData = { .rectangle = {
@@ -2999,10 +4884,12 @@ void Clay__CalculateFinalLayout(void) {
             }
             else {
                 // DFS is returning upwards backwards
+                Clay__UpdateSubtreeHitTestBounds(currentElement);
+                bool offscreen = currentElementTreeNode->offscreen;
                 bool closeClipElement = false;
                 Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
                 if (clipConfig) {
-                    closeClipElement = true;
+                    closeClipElement = !offscreen;
                     for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
                         Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
                         if (mapping->layoutElement == currentElement) {
@@ -3019,8 +4906,11 @@ void Clay__CalculateFinalLayout(void) {
                     Clay_LayoutElementHashMapItem *currentElementData = Clay__GetHashMapItem(currentElement->id);
                     Clay_BoundingBox currentElementBoundingBox = currentElementData->boundingBox;
 
-                    // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
-                    if (!Clay__ElementIsOffscreen(&currentElementBoundingBox)) {
+                    if (offscreen) {
+                        Clay_BorderElementConfig *borderConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER).borderElementConfig;
+                        bool betweenChildren = borderConfig->width.betweenChildren > 0 && borderConfig->color.a > 0;
+                        context->cullingStats.culledRenderCommandCount += 1 + (betweenChildren ? CLAY__MAX(currentElement->childrenOrTextContent.children.length - 1, 0) : 0);
+                    } else {
                         Clay_SharedElementConfig *sharedConfig = Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED) ? Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED).sharedElementConfig : &Clay_SharedElementConfig_DEFAULT;
                         Clay_BorderElementConfig *borderConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER).borderElementConfig;
                         Clay_RenderCommand renderCommand = {
@@ -3086,8 +4976,13 @@ void Clay__CalculateFinalLayout(void) {
                 continue;
             }
 
+            if (cullSubtree) {
+                context->cullingStats.culledSubtreeCount++;
+                context->cullingStats.culledElementCount += context->layoutElementSubtreeSizes.internalArray[currentElementIndex] - 1;
+            }
+
             // Add children to the DFS buffer
-            if (!Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+            if (!cullSubtree && !Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
                 dfsBuffer.length += currentElement->childrenOrTextContent.children.length;
                 for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
                     Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
@@ -3121,6 +5016,7 @@ void Clay__CalculateFinalLayout(void) {
                         .layoutElement = childElement,
                         .position = { childPosition.x, childPosition.y },
                         .nextChildOffset = { .x = (float)childElement->layoutConfig->padding.left, .y = (float)childElement->layoutConfig->padding.top },
+                        .cullRect = currentElementTreeNode->cullRect,
                     };
                     context->treeNodeVisited.internalArray[newNodeIndex] = false;
 
@@ -3138,6 +5034,7 @@ void Clay__CalculateFinalLayout(void) {
             Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) { .id = Clay__HashNumber(rootElement->id, rootElement->childrenOrTextContent.children.length + 11).id, .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END });
         }
     }
+    CLAY_PROFILE_END(CLAY_PROFILE_PHASE_RENDER_COMMANDS, context->renderCommands.length);
 }
 
 CLAY_WASM_EXPORT("Clay_GetPointerOverIds")
@@ -3236,7 +5133,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
                         .cornerRadius = CLAY_CORNER_RADIUS(4),
                         .border = { .color = CLAY__DEBUGVIEW_COLOR_3, .width = {1, 1, 1, 1, 0} },
                     }) {
-                        CLAY_TEXT((currentElementData && currentElementData->debugData->collapsed) ? CLAY_STRING("+") : CLAY_STRING("-"), CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_4, .fontSize = 16 }));
+                        CLAY_TEXT((currentElementData && Clay__GetHashMapItemDebugData(currentElementData)->collapsed) ? CLAY_STRING("+") : CLAY_STRING("-"), CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_4, .fontSize = 16 }));
                     }
                 } else { // Square dot for empty containers
                     CLAY_AUTO_ID({ .layout = { .sizing = {CLAY_SIZING_FIXED(16), CLAY_SIZING_FIXED(16)}, .childAlignment = { CLAY_ALIGN_X_CENTER, CLAY_ALIGN_Y_CENTER } } }) {
@@ -3245,7 +5142,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
                 }
                 // Collisions and offscreen info
                 if (currentElementData) {
-                    if (currentElementData->debugData->collision) {
+                    if (Clay__GetHashMapItemDebugData(currentElementData)->collision) {
                         CLAY_AUTO_ID({ .layout = { .padding = { 8, 8, 2, 2 }}, .border = { .color = {177, 147, 8, 255}, .width = {1, 1, 1, 1, 0} } }) {
                             CLAY_TEXT(CLAY_STRING("Duplicate ID"), CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_3, .fontSize = 16 }));
                         }
@@ -3312,7 +5209,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
             }
 
             layoutData.rowCount++;
-            if (!(Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || (currentElementData && currentElementData->debugData->collapsed))) {
+            if (!(Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || (currentElementData && Clay__GetHashMapItemDebugData(currentElementData)->collapsed))) {
                 for (int32_t i = currentElement->childrenOrTextContent.children.length - 1; i >= 0; --i) {
                     Clay__int32_tArray_Add(&dfsBuffer, currentElement->childrenOrTextContent.children.elements[i]);
                     context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
@@ -3327,7 +5224,8 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
             Clay_ElementId *elementId = Clay_ElementIdArray_Get(&context->pointerOverIds, i);
             if (elementId->baseId == collapseButtonId.baseId) {
                 Clay_LayoutElementHashMapItem *highlightedItem = Clay__GetHashMapItem(elementId->offset);
-                highlightedItem->debugData->collapsed = !highlightedItem->debugData->collapsed;
+                Clay__DebugElementData *debugData = Clay__GetHashMapItemDebugData(highlightedItem);
+                debugData->collapsed = !debugData->collapsed;
                 break;
             }
         }
@@ -3509,6 +5407,7 @@ void Clay__RenderDebugView(void) {
         CLAY_AUTO_ID({ .layout = { .sizing = {.width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIXED(1)} }, .backgroundColor = CLAY__DEBUGVIEW_COLOR_3 }) {}
         if (context->debugSelectedElementId != 0) {
             Clay_LayoutElementHashMapItem *selectedItem = Clay__GetHashMapItem(context->debugSelectedElementId);
+            Clay_ElementId selectedElementId = Clay__GetHashMapItemColdData(selectedItem)->elementId;
             CLAY_AUTO_ID({
                 .layout = { .sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(300)}, .layoutDirection = CLAY_TOP_TO_BOTTOM },
                 .backgroundColor = CLAY__DEBUGVIEW_COLOR_2 ,
@@ -3518,11 +5417,11 @@ void Clay__RenderDebugView(void) {
                 CLAY_AUTO_ID({ .layout = { .sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(CLAY__DEBUGVIEW_ROW_HEIGHT + 8)}, .padding = {CLAY__DEBUGVIEW_OUTER_PADDING, CLAY__DEBUGVIEW_OUTER_PADDING, 0, 0 }, .childAlignment = {.y = CLAY_ALIGN_Y_CENTER} } }) {
                     CLAY_TEXT(CLAY_STRING("Layout Config"), infoTextConfig);
                     CLAY_AUTO_ID({ .layout = { .sizing = { .width = CLAY_SIZING_GROW(0) } } }) {}
-                    if (selectedItem->elementId.stringId.length != 0) {
-                        CLAY_TEXT(selectedItem->elementId.stringId, infoTitleConfig);
-                        if (selectedItem->elementId.offset != 0) {
+                    if (selectedElementId.stringId.length != 0) {
+                        CLAY_TEXT(selectedElementId.stringId, infoTitleConfig);
+                        if (selectedElementId.offset != 0) {
                             CLAY_TEXT(CLAY_STRING(" ("), infoTitleConfig);
-                            CLAY_TEXT(Clay__IntToString(selectedItem->elementId.offset), infoTitleConfig);
+                            CLAY_TEXT(Clay__IntToString(selectedElementId.offset), infoTitleConfig);
                             CLAY_TEXT(CLAY_STRING(")"), infoTitleConfig);
                         }
                     }
@@ -3597,7 +5496,7 @@ void Clay__RenderDebugView(void) {
                 }
                 for (int32_t elementConfigIndex = 0; elementConfigIndex < selectedItem->layoutElement->elementConfigs.length; ++elementConfigIndex) {
                     Clay_ElementConfig *elementConfig = Clay__ElementConfigArraySlice_Get(&selectedItem->layoutElement->elementConfigs, elementConfigIndex);
-                    Clay__RenderDebugViewElementConfigHeader(selectedItem->elementId.stringId, elementConfig->type);
+                    Clay__RenderDebugViewElementConfigHeader(selectedElementId.stringId, elementConfig->type);
                     switch (elementConfig->type) {
                         case CLAY__ELEMENT_CONFIG_TYPE_SHARED: {
                             Clay_SharedElementConfig *sharedConfig = elementConfig->config.sharedElementConfig;
@@ -3720,7 +5619,7 @@ void Clay__RenderDebugView(void) {
                                 // .parentId
                                 CLAY_TEXT(CLAY_STRING("Parent"), infoTitleConfig);
                                 Clay_LayoutElementHashMapItem *hashItem = Clay__GetHashMapItem(floatingConfig->parentId);
-                                CLAY_TEXT(hashItem->elementId.stringId, infoTextConfig);
+                                CLAY_TEXT(Clay__GetHashMapItemColdData(hashItem)->elementId.stringId, infoTextConfig);
                                 // .attachPoints
                                 CLAY_TEXT(CLAY_STRING("Attach Points"), infoTitleConfig);
                                 CLAY_AUTO_ID({ .layout = { .layoutDirection = CLAY_LEFT_TO_RIGHT } }) {
@@ -3902,12 +5801,15 @@ bool Clay__Array_RangeCheck(int32_t index, int32_t length)
     return false;
 }
 
-bool Clay__Array_AddCapacityCheck(int32_t length, int32_t capacity)
+bool Clay__Array_AddCapacityCheck(int32_t length, int32_t *capacity)
 {
-    if (length < capacity) {
+    if (length < *capacity) {
         return true;
     }
     Clay_Context* context = Clay_GetCurrentContext();
+    if (Clay__GrowArrayToFit(context, capacity, length + 1)) {
+        return true;
+    }
     context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
         .errorType = CLAY_ERROR_TYPE_INTERNAL_ERROR,
         .errorText = CLAY_STRING("Clay attempted to make an out of bounds array access. This is an internal error and is likely a bug."),
@@ -3915,13 +5817,12 @@ bool Clay__Array_AddCapacityCheck(int32_t length, int32_t capacity)
     return false;
 }
 
-// PUBLIC API FROM HERE ---------------------------------------
-
-CLAY_WASM_EXPORT("Clay_MinMemorySize")
-uint32_t Clay_MinMemorySize(void) {
+// The size of an arena with room for maxElementCount elements, and the other capacities of the current context or the defaults
+size_t Clay__ArenaSize(int32_t maxElementCount) {
     Clay_Context fakeContext = {
-        .maxElementCount = Clay__defaultMaxElementCount,
+        .maxElementCount = maxElementCount,
         .maxMeasureTextCacheWordCount = Clay__defaultMaxMeasureTextWordCacheCount,
+        .arrayCapacities = Clay__defaultArrayCapacities,
         .internalArena = {
             .capacity = SIZE_MAX,
             .memory = NULL,
@@ -3929,14 +5830,22 @@ uint32_t Clay_MinMemorySize(void) {
     };
     Clay_Context* currentContext = Clay_GetCurrentContext();
     if (currentContext) {
-        fakeContext.maxElementCount = currentContext->maxElementCount;
         fakeContext.maxMeasureTextCacheWordCount = currentContext->maxMeasureTextCacheWordCount;
+        fakeContext.arrayCapacities = currentContext->arrayCapacities;
     }
     // Reserve space in the arena for the context, important for calculating min memory size correctly
     Clay__Context_Allocate_Arena(&fakeContext.internalArena);
     Clay__InitializePersistentMemory(&fakeContext);
     Clay__InitializeEphemeralMemory(&fakeContext);
-    return (uint32_t)fakeContext.internalArena.nextAllocation + 128;
+    return (size_t)fakeContext.internalArena.nextAllocation + 128;
+}
+
+// PUBLIC API FROM HERE ---------------------------------------
+
+CLAY_WASM_EXPORT("Clay_MinMemorySize")
+uint32_t Clay_MinMemorySize(void) {
+    Clay_Context* currentContext = Clay_GetCurrentContext();
+    return (uint32_t)Clay__ArenaSize(currentContext ? currentContext->maxElementCount : Clay__defaultMaxElementCount);
 }
 
 CLAY_WASM_EXPORT("Clay_CreateArenaWithCapacityAndMemory")
@@ -3953,12 +5862,30 @@ void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_Str
     Clay_Context* context = Clay_GetCurrentContext();
     Clay__MeasureText = measureTextFunction;
     context->measureTextUserData = userData;
+    context->layoutCacheValid = false;
+}
+void Clay_SetMeasureTextBatchFunction(void (*measureTextBatchFunction)(const Clay_TextMeasurementRequest *requests, Clay_Dimensions *dimensions, int32_t requestCount, void *userData), void *userData) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->measureTextBatchFunction = measureTextBatchFunction;
+    context->measureTextBatchUserData = userData;
+    context->layoutCacheValid = false;
 }
 void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData), void *userData) {
     Clay_Context* context = Clay_GetCurrentContext();
     Clay__QueryScrollOffset = queryScrollOffsetFunction;
     context->queryScrollOffsetUserData = userData;
 }
+void Clay_SetLayoutJobFunction(void (*runJobsFunction)(void (*job)(int32_t jobIndex, void *jobData), void *jobData, int32_t jobCount, void *userData), void *userData) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->layoutJobFunction = runJobsFunction;
+    context->layoutJobUserData = userData;
+}
+
+void Clay_SetProfileCallback(void (*profileFunction)(const Clay_ProfileFrame *frame, void *userData), void *userData) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->profileFunction = profileFunction;
+    context->profileUserData = userData;
+}
 #endif
 
 CLAY_WASM_EXPORT("Clay_SetLayoutDimensions")
@@ -3975,6 +5902,8 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
     context->pointerInfo.position = position;
     context->pointerOverIds.length = 0;
     Clay__int32_tArray dfsBuffer = context->layoutElementChildrenBuffer;
+    // Outside of declaration, the hit test bounds from the last layout let whole subtrees that don't contain the pointer be skipped
+    bool useHitTestBounds = context->hitTestBoundsValid;
     for (int32_t rootIndex = context->layoutElementTreeRoots.length - 1; rootIndex >= 0; --rootIndex) {
         dfsBuffer.length = 0;
         Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
@@ -3987,31 +5916,66 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
                 continue;
             }
             context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
-            Clay_LayoutElement *currentElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&dfsBuffer, (int)dfsBuffer.length - 1));
-            Clay_LayoutElementHashMapItem *mapItem = Clay__GetHashMapItem(currentElement->id); // TODO think of a way around this, maybe the fact that it's essentially a binary tree limits the cost, but the worst case is not great
-            int32_t clipElementId = Clay__int32_tArray_GetValue(&context->layoutElementClipElementIds, (int32_t)(currentElement - context->layoutElements.internalArray));
-            Clay_LayoutElementHashMapItem *clipItem = Clay__GetHashMapItem(clipElementId);
-            if (mapItem) {
-                Clay_BoundingBox elementBox = mapItem->boundingBox;
-                elementBox.x -= root->pointerOffset.x;
-                elementBox.y -= root->pointerOffset.y;
-                if ((Clay__PointIsInsideRect(position, elementBox)) && (clipElementId == 0 || (Clay__PointIsInsideRect(position, clipItem->boundingBox)) || context->externalScrollHandlingEnabled)) {
-                    if (mapItem->onHoverFunction) {
-                        mapItem->onHoverFunction(mapItem->elementId, context->pointerInfo, mapItem->hoverFunctionUserData);
+            int32_t currentElementIndex = Clay__int32_tArray_GetValue(&dfsBuffer, (int)dfsBuffer.length - 1);
+            Clay_LayoutElement *currentElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElementIndex);
+            Clay__ElementHitTestBounds *hitTestBounds = &context->layoutElementHitTestBounds.internalArray[currentElementIndex];
+            if (useHitTestBounds && !(position.x >= hitTestBounds->subtreeMin.x - root->pointerOffset.x && position.x <= hitTestBounds->subtreeMax.x - root->pointerOffset.x
+                    && position.y >= hitTestBounds->subtreeMin.y - root->pointerOffset.y && position.y <= hitTestBounds->subtreeMax.y - root->pointerOffset.y)) {
+                dfsBuffer.length--;
+                continue;
+            }
+            Clay_LayoutElementHashMapItem *mapItem = useHitTestBounds ? CLAY__NULL : Clay__GetHashMapItem(currentElement->id);
+            Clay_BoundingBox elementBox = useHitTestBounds ? hitTestBounds->boundingBox : mapItem->boundingBox;
+            elementBox.x -= root->pointerOffset.x;
+            elementBox.y -= root->pointerOffset.y;
+            if (Clay__PointIsInsideRect(position, elementBox)) {
+                int32_t clipElementId = Clay__int32_tArray_GetValue(&context->layoutElementClipElementIds, currentElementIndex);
+                if (clipElementId == 0 || Clay__PointIsInsideRect(position, Clay__GetHashMapItem(clipElementId)->boundingBox) || context->externalScrollHandlingEnabled) {
+                    if (!mapItem) {
+                        mapItem = Clay__GetHashMapItem(currentElement->id);
                     }
-                    Clay_ElementIdArray_Add(&context->pointerOverIds, mapItem->elementId);
+                    Clay__LayoutElementHashMapItemColdData *coldData = Clay__GetHashMapItemColdData(mapItem);
+                    if (coldData->onHoverFunction) {
+                        coldData->onHoverFunction(coldData->elementId, context->pointerInfo, coldData->hoverFunctionUserData);
+                    }
+                    Clay_ElementIdArray_Add(&context->pointerOverIds, coldData->elementId);
                     found = true;
                 }
-                if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
-                    dfsBuffer.length--;
-                    continue;
+            }
+            // Culled subtrees are entirely outside the visible region of the screen, so their children can't be under the pointer
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || (useHitTestBounds && hitTestBounds->subtreeCulled)) {
+                dfsBuffer.length--;
+                continue;
+            }
+            int32_t firstChild = 0;
+            int32_t lastChild = currentElement->childrenOrTextContent.children.length - 1;
+            if (useHitTestBounds && hitTestBounds->childrenOrdered) {
+                // Children are sorted along the layout axis, so only the run of children whose extent along it contains the pointer needs visiting
+                bool horizontal = currentElement->layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT;
+                float pointerPosition = horizontal ? position.x : position.y;
+                float pointerOffset = horizontal ? root->pointerOffset.x : root->pointerOffset.y;
+                int32_t high = lastChild + 1;
+                while (firstChild < high) {
+                    int32_t middle = firstChild + (high - firstChild) / 2;
+                    Clay__ElementHitTestBounds *childBounds = &context->layoutElementHitTestBounds.internalArray[currentElement->childrenOrTextContent.children.elements[middle]];
+                    if ((horizontal ? childBounds->subtreeMax.x : childBounds->subtreeMax.y) - pointerOffset < pointerPosition) {
+                        firstChild = middle + 1;
+                    } else {
+                        high = middle;
+                    }
                 }
-                for (int32_t i = currentElement->childrenOrTextContent.children.length - 1; i >= 0; --i) {
-                    Clay__int32_tArray_Add(&dfsBuffer, currentElement->childrenOrTextContent.children.elements[i]);
-                    context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
+                lastChild = firstChild - 1;
+                while (lastChild + 1 < currentElement->childrenOrTextContent.children.length) {
+                    Clay__ElementHitTestBounds *childBounds = &context->layoutElementHitTestBounds.internalArray[currentElement->childrenOrTextContent.children.elements[lastChild + 1]];
+                    if ((horizontal ? childBounds->subtreeMin.x : childBounds->subtreeMin.y) - pointerOffset > pointerPosition) {
+                        break;
+                    }
+                    lastChild++;
                 }
-            } else {
-                dfsBuffer.length--;
+            }
+            for (int32_t i = lastChild; i >= firstChild; --i) {
+                Clay__int32_tArray_Add(&dfsBuffer, currentElement->childrenOrTextContent.children.elements[i]);
+                context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
             }
         }
 
@@ -4037,37 +6001,96 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
     }
 }
 
-CLAY_WASM_EXPORT("Clay_Initialize")
-Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler) {
+Clay_Context* Clay__InitializeContext(Clay_Arena arena, int32_t maxElementCount, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler, Clay_ArenaMemoryFunctions memoryFunctions) {
     // Cacheline align memory passed in
     uintptr_t baseOffset = 64 - ((uintptr_t)arena.memory % 64);
     baseOffset = baseOffset == 64 ? 0 : baseOffset;
     arena.memory += baseOffset;
     Clay_Context *context = Clay__Context_Allocate_Arena(&arena);
     if (context == NULL) return NULL;
+    // The context has to be committed before it can be written to, which is only possible once it knows how to commit memory
+    if (memoryFunctions.commitFunction) {
+        uintptr_t contextEnd = ((uintptr_t)(context + 1) + CLAY__ARENA_PAGE_SIZE - 1) & ~(uintptr_t)(CLAY__ARENA_PAGE_SIZE - 1);
+        uintptr_t contextStart = (uintptr_t)context & ~(uintptr_t)(CLAY__ARENA_PAGE_SIZE - 1);
+        if (!memoryFunctions.commitFunction((void *)contextStart, (size_t)(contextEnd - contextStart), memoryFunctions.userData)) {
+            return NULL;
+        }
+    }
     // DEFAULTS
     Clay_Context *oldContext = Clay_GetCurrentContext();
     *context = CLAY__INIT(Clay_Context) {
-        .maxElementCount = oldContext ? oldContext->maxElementCount : Clay__defaultMaxElementCount,
+        .maxElementCount = maxElementCount,
         .maxMeasureTextCacheWordCount = oldContext ? oldContext->maxMeasureTextCacheWordCount : Clay__defaultMaxMeasureTextWordCacheCount,
+        .elementCapacity = memoryFunctions.commitFunction ? CLAY__MIN(CLAY__GROWABLE_INITIAL_ELEMENT_COUNT, maxElementCount) : maxElementCount,
+        .arrayCapacities = oldContext ? oldContext->arrayCapacities : Clay__defaultArrayCapacities,
         .errorHandler = errorHandler.errorHandlerFunction ? errorHandler : CLAY__INIT(Clay_ErrorHandler) { Clay__ErrorHandlerFunctionDefault, 0 },
         .layoutDimensions = layoutDimensions,
         .internalArena = arena,
+        .arenaMemoryFunctions = memoryFunctions,
     };
     Clay_SetCurrentContext(context);
     Clay__InitializePersistentMemory(context);
     Clay__InitializeEphemeralMemory(context);
+    if (memoryFunctions.commitFunction) {
+        Clay__CommitArenaMemory(context);
+    }
     for (int32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
-        context->layoutElementsHashMap.internalArray[i] = -1;
+        context->layoutElementsHashMap.internalArray[i] = CLAY__INIT(Clay__LayoutElementHashMapGroup) CLAY__DEFAULT_STRUCT;
     }
     for (int32_t i = 0; i < context->measureTextHashMap.capacity; ++i) {
         context->measureTextHashMap.internalArray[i] = 0;
     }
+    // Kept empty between frames by Clay__DiffRenderCommands
+    for (int32_t i = 0; i < context->renderCommandDiffHashMap.capacity; ++i) {
+        context->renderCommandDiffHashMap.internalArray[i] = 0;
+    }
     context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
     context->layoutDimensions = layoutDimensions;
     return context;
 }
 
+CLAY_WASM_EXPORT("Clay_Initialize")
+Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler) {
+    Clay_Context *oldContext = Clay_GetCurrentContext();
+    int32_t maxElementCount = oldContext ? oldContext->maxElementCount : Clay__defaultMaxElementCount;
+    return Clay__InitializeContext(arena, maxElementCount, layoutDimensions, errorHandler, CLAY__INIT(Clay_ArenaMemoryFunctions) CLAY__DEFAULT_STRUCT);
+}
+
+CLAY_WASM_EXPORT("Clay_InitializeGrowable")
+Clay_Context* Clay_InitializeGrowable(Clay_ArenaMemoryFunctions memoryFunctions, int32_t maxReservedElementCount, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler) {
+    if (!memoryFunctions.reserveFunction || !memoryFunctions.commitFunction) {
+        return NULL;
+    }
+    Clay_Context *oldContext = Clay_GetCurrentContext();
+    int32_t maxElementCount = CLAY__MAX(maxReservedElementCount, oldContext ? oldContext->maxElementCount : Clay__defaultMaxElementCount);
+    // Reserves the same amount of memory as a fixed arena for the reserved element count, which commits every array at its full size
+    size_t capacity = (Clay__ArenaSize(maxElementCount) + CLAY__ARENA_PAGE_SIZE - 1) & ~(size_t)(CLAY__ARENA_PAGE_SIZE - 1);
+    void *memory = memoryFunctions.reserveFunction(capacity, memoryFunctions.userData);
+    if (memory == NULL) {
+        return NULL;
+    }
+    Clay_Context *context = Clay__InitializeContext(Clay_CreateArenaWithCapacityAndMemory(capacity, memory), maxElementCount, layoutDimensions, errorHandler, memoryFunctions);
+    if (context == NULL && memoryFunctions.releaseFunction) {
+        memoryFunctions.releaseFunction(memory, capacity, memoryFunctions.userData);
+    }
+    return context;
+}
+
+CLAY_WASM_EXPORT("Clay_ReleaseGrowable")
+void Clay_ReleaseGrowable(Clay_Context *context) {
+    if (context == NULL || !context->arenaMemoryFunctions.releaseFunction) {
+        return;
+    }
+    // Copied out first, because they are stored in the memory being released
+    Clay_ArenaMemoryFunctions memoryFunctions = context->arenaMemoryFunctions;
+    Clay_Arena arena = context->internalArena;
+    if (Clay_GetCurrentContext() == context) {
+        Clay_SetCurrentContext(NULL);
+    }
+    // The reserved memory is page aligned, so the context was allocated at its start
+    memoryFunctions.releaseFunction(arena.memory, arena.capacity, memoryFunctions.userData);
+}
+
 CLAY_WASM_EXPORT("Clay_GetCurrentContext")
 Clay_Context* Clay_GetCurrentContext(void) {
     return Clay__currentContext;
@@ -4212,12 +6235,276 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
     }
 }
 
+bool Clay__LayoutCacheHit(Clay_Context *context) {
+    if (!context->layoutCachingEnabled || !context->layoutCacheValid || context->debugModeEnabled) {
+        return false;
+    }
+    Clay_BooleanWarnings warnings = context->booleanWarnings;
+    if (warnings.maxElementsExceeded || warnings.maxRenderCommandsExceeded || warnings.maxTextMeasureCacheExceeded || warnings.textMeasurementFunctionNotSet) {
+        return false;
+    }
+    return context->layoutInputHash == context->previousLayoutInputHash;
+}
+
+void Clay__StoreCachedLayout(Clay_Context *context) {
+    Clay_BooleanWarnings warnings = context->booleanWarnings;
+    bool hasWarnings = warnings.maxElementsExceeded || warnings.maxRenderCommandsExceeded || warnings.maxTextMeasureCacheExceeded || warnings.textMeasurementFunctionNotSet;
+    // Floating elements can be positioned relative to the previous frame's bounding boxes, so a layout is only
+    // reused once it has been calculated twice in a row from identical input
+    context->layoutCacheValid = !hasWarnings && !context->debugModeEnabled && context->layoutInputHash == context->previousLayoutInputHash;
+    context->previousLayoutInputHash = context->layoutInputHash;
+    context->cachedRenderCommandsLength = context->renderCommands.length;
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        context->cachedLayoutElementDimensions.internalArray[i] = context->layoutElements.internalArray[i].dimensions;
+    }
+}
+
+// Render commands live in ephemeral memory at the same location every frame, and are not written to during declaration,
+// so the previous frame's render commands are still intact and only their length needs to be restored
+void Clay__RestoreCachedLayout(Clay_Context *context) {
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        context->layoutElements.internalArray[i].dimensions = context->cachedLayoutElementDimensions.internalArray[i];
+    }
+    Clay__SortLayoutElementTreeRoots();
+    context->renderCommands.length = context->cachedRenderCommandsLength;
+}
+
+// Hashes the fields of a render command that are relevant to its command type. Text is hashed by its contents rather than its address,
+// since the previous frame's strings may no longer be valid.
+uint64_t Clay__HashRenderCommandContents(Clay_RenderCommand *command) {
+    uint64_t hash = Clay__HashData((const uint8_t *)&command->boundingBox, sizeof(Clay_BoundingBox));
+    hash = Clay__HashCombine(hash, (uintptr_t)command->userData);
+    hash = Clay__HashCombine(hash, (uint64_t)(uint16_t)command->zIndex);
+    Clay_RenderData *renderData = &command->renderData;
+    switch (command->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            hash = Clay__HashCombine(hash, Clay__HashData((const uint8_t *)&renderData->rectangle, sizeof(Clay_RectangleRenderData)));
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+            hash = Clay__HashCombine(hash, Clay__HashData((const uint8_t *)&renderData->border.color, sizeof(Clay_Color)));
+            hash = Clay__HashCombine(hash, Clay__HashData((const uint8_t *)&renderData->border.cornerRadius, sizeof(Clay_CornerRadius)));
+            hash = Clay__HashCombine(hash, Clay__HashData((const uint8_t *)&renderData->border.width, sizeof(Clay_BorderWidth)));
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            Clay_TextRenderData *text = &renderData->text;
+            hash = Clay__HashCombine(hash, Clay__HashData((const uint8_t *)text->stringContents.chars, text->stringContents.length));
+            hash = Clay__HashCombine(hash, (uint64_t)text->stringContents.length);
+            hash = Clay__HashCombine(hash, Clay__HashData((const uint8_t *)&text->textColor, sizeof(Clay_Color)));
+            hash = Clay__HashCombine(hash, (uint64_t)text->fontId | (uint64_t)text->fontSize << 16 | (uint64_t)text->letterSpacing << 32 | (uint64_t)text->lineHeight << 48);
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            hash = Clay__HashCombine(hash, Clay__HashData((const uint8_t *)&renderData->image, sizeof(Clay_ImageRenderData)));
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+            hash = Clay__HashCombine(hash, Clay__HashData((const uint8_t *)&renderData->custom, sizeof(Clay_CustomRenderData)));
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+            hash = Clay__HashCombine(hash, (uint64_t)renderData->clip.horizontal | (uint64_t)renderData->clip.vertical << 1);
+            break;
+        }
+        default: break;
+    }
+    return hash;
+}
+
+uint32_t Clay__RenderCommandSnapshotHash(Clay__RenderCommandSnapshot *snapshot) {
+    uint64_t hash = Clay__HashCombine(Clay__HashCombine(snapshot->id, snapshot->commandType), (uint64_t)snapshot->occurrence);
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+bool Clay__RenderCommandSnapshotKeysEqual(Clay__RenderCommandSnapshot *a, Clay__RenderCommandSnapshot *b) {
+    return a->id == b->id && a->commandType == b->commandType && a->occurrence == b->occurrence;
+}
+
+// Adds a changed area to the damage rectangles, merging it with any rectangles it overlaps
+void Clay__AddDamageRectangle(Clay_Context *context, Clay_BoundingBox box) {
+    Clay_BoundingBoxArray *damageRectangles = &context->damageRectangles;
+    box = Clay__IntersectBoundingBoxes(box, CLAY__INIT(Clay_BoundingBox) { 0, 0, context->layoutDimensions.width, context->layoutDimensions.height });
+    if (box.width <= 0 || box.height <= 0) {
+        return;
+    }
+    // Merging can make a rectangle overlap others that it didn't before, so the merged rectangle is checked again until nothing overlaps.
+    // Rectangles that only touch are merged too, e.g. adjacent rows of a list.
+    for (int32_t i = 0; i < damageRectangles->length; ++i) {
+        Clay_BoundingBox other = damageRectangles->internalArray[i];
+        if (box.x <= other.x + other.width && other.x <= box.x + box.width && box.y <= other.y + other.height && other.y <= box.y + box.height) {
+            box = Clay__UnionBoundingBoxes(box, damageRectangles->internalArray[i]);
+            damageRectangles->internalArray[i] = damageRectangles->internalArray[--damageRectangles->length];
+            i = -1;
+        }
+    }
+    if (damageRectangles->length == damageRectangles->capacity) {
+        // Too many separate areas have changed to redraw them individually
+        for (int32_t i = 0; i < damageRectangles->length; ++i) {
+            box = Clay__UnionBoundingBoxes(box, damageRectangles->internalArray[i]);
+        }
+        damageRectangles->length = 0;
+    }
+    Clay_BoundingBoxArray_Add(damageRectangles, box);
+}
+
+// Damages the previous and current areas of every changed render command. Scissor commands don't draw anything themselves,
+// but damage the area where content may have been revealed or hidden.
+void Clay__CalculateDamageRectangles(Clay_Context *context) {
+    Clay__RenderCommandSnapshotArray *snapshotArrays[] = { &context->previousRenderCommandSnapshots, &context->renderCommandSnapshots };
+    for (int32_t arrayIndex = 0; arrayIndex < 2; ++arrayIndex) {
+        Clay__RenderCommandSnapshotArray *snapshots = snapshotArrays[arrayIndex];
+        for (int32_t i = 0; i < snapshots->length; ++i) {
+            Clay__RenderCommandSnapshot *snapshot = &snapshots->internalArray[i];
+            if (snapshot->changed && snapshot->commandType != CLAY_RENDER_COMMAND_TYPE_SCISSOR_END) {
+                Clay__AddDamageRectangle(context, snapshot->visibleBoundingBox);
+            }
+        }
+    }
+}
+
+// Compares this frame's render commands with the previous frame's, then stores them to be compared with the next frame's
+void Clay__DiffRenderCommands(Clay_Context *context, bool layoutCacheHit) {
+    Clay_RenderCommandDiff *diff = &context->renderCommandDiff;
+    Clay_RenderCommandArray *renderCommands = &context->renderCommands;
+    Clay__RenderCommandSnapshotArray *previousSnapshots = &context->previousRenderCommandSnapshots;
+    // A cached layout is only reused if its render commands are identical, and the stored commands are already the same
+    if (layoutCacheHit && context->renderCommandSnapshotsValid) {
+        diff->unchanged = true;
+        return;
+    }
+    if (!context->renderCommandSnapshotsValid && context->damageTrackingEnabled) {
+        // Nothing is known about what is currently on the screen
+        Clay_BoundingBoxArray_Add(&context->damageRectangles, CLAY__INIT(Clay_BoundingBox) { 0, 0, context->layoutDimensions.width, context->layoutDimensions.height });
+    }
+
+    Clay__RenderCommandSnapshotArray *snapshots = &context->renderCommandSnapshots;
+    if (renderCommands->length > CLAY__MIN(snapshots->capacity, diff->inserted.capacity)) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay ran out of capacity for comparing render commands between frames. Try using Clay_SetArrayCapacities() with a higher .diffedRenderCommands."),
+            .userData = context->errorHandler.userData });
+        // The commands can't be stored, so the next frame can't be compared with this one either
+        if (context->renderCommandSnapshotsValid && context->damageTrackingEnabled) {
+            Clay_BoundingBoxArray_Add(&context->damageRectangles, CLAY__INIT(Clay_BoundingBox) { 0, 0, context->layoutDimensions.width, context->layoutDimensions.height });
+        }
+        diff->unchanged = false;
+        context->renderCommandSnapshotsValid = false;
+        return;
+    }
+    snapshots->length = renderCommands->length;
+    bool unchanged = context->renderCommandSnapshotsValid && renderCommands->length == previousSnapshots->length;
+    int32_t clipIndex = -1;
+    for (int32_t i = 0; i < renderCommands->length; ++i) {
+        Clay_RenderCommand *command = &renderCommands->internalArray[i];
+        Clay__RenderCommandSnapshot *snapshot = &snapshots->internalArray[i];
+        *snapshot = CLAY__INIT(Clay__RenderCommandSnapshot) { .contentHash = Clay__HashRenderCommandContents(command), .id = command->id, .clipIndex = clipIndex, .visibleBoundingBox = command->boundingBox, .commandType = command->commandType };
+        if (i > 0 && snapshots->internalArray[i - 1].id == snapshot->id && snapshots->internalArray[i - 1].commandType == snapshot->commandType) {
+            snapshot->occurrence = snapshots->internalArray[i - 1].occurrence + 1;
+        }
+        if (clipIndex != -1) {
+            snapshot->visibleBoundingBox = Clay__IntersectBoundingBoxes(snapshot->visibleBoundingBox, snapshots->internalArray[clipIndex].visibleBoundingBox);
+        }
+        if (command->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START) {
+            clipIndex = i;
+        } else if (command->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END && clipIndex != -1) {
+            clipIndex = snapshots->internalArray[clipIndex].clipIndex;
+        }
+        if (unchanged) {
+            Clay__RenderCommandSnapshot *previous = &previousSnapshots->internalArray[i];
+            unchanged = Clay__RenderCommandSnapshotKeysEqual(snapshot, previous) && snapshot->contentHash == previous->contentHash;
+        }
+    }
+    diff->unchanged = unchanged;
+
+    if (!unchanged) {
+        if (!context->renderCommandSnapshotsValid) {
+            previousSnapshots->length = 0;
+        }
+        // Index the previous frame's commands by key. The 0 value is reserved to mean "empty slot", so indexes are offset by one.
+        Clay__int32_tArray *hashMap = &context->renderCommandDiffHashMap;
+        uint32_t mask = (uint32_t)hashMap->capacity - 1;
+        for (int32_t i = 0; i < previousSnapshots->length; ++i) {
+            Clay__RenderCommandSnapshot *previous = &previousSnapshots->internalArray[i];
+            previous->matched = false;
+            previous->changed = false;
+            previous->hashMapSlot = -1;
+            for (uint32_t slot = Clay__RenderCommandSnapshotHash(previous) & mask;; slot = (slot + 1) & mask) {
+                int32_t existing = hashMap->internalArray[slot];
+                if (existing == 0) {
+                    hashMap->internalArray[slot] = i + 1;
+                    previous->hashMapSlot = (int32_t)slot;
+                    break;
+                }
+                // Duplicate keys can only come from duplicate element ids, and the later commands are reported as removed
+                if (Clay__RenderCommandSnapshotKeysEqual(&previousSnapshots->internalArray[existing - 1], previous)) {
+                    break;
+                }
+            }
+        }
+
+        for (int32_t i = 0; i < snapshots->length; ++i) {
+            Clay__RenderCommandSnapshot *snapshot = &snapshots->internalArray[i];
+            Clay__RenderCommandSnapshot *previous = NULL;
+            int32_t previousIndex = -1;
+            for (uint32_t slot = Clay__RenderCommandSnapshotHash(snapshot) & mask; hashMap->internalArray[slot] != 0; slot = (slot + 1) & mask) {
+                Clay__RenderCommandSnapshot *candidate = &previousSnapshots->internalArray[hashMap->internalArray[slot] - 1];
+                if (Clay__RenderCommandSnapshotKeysEqual(candidate, snapshot)) {
+                    if (!candidate->matched) {
+                        previous = candidate;
+                        previousIndex = hashMap->internalArray[slot] - 1;
+                    }
+                    break;
+                }
+            }
+            if (!previous) {
+                snapshot->changed = true;
+                Clay_RenderCommandArray_Add(&diff->inserted, renderCommands->internalArray[i]);
+                continue;
+            }
+            previous->matched = true;
+            if (previous->contentHash != snapshot->contentHash) {
+                snapshot->changed = true;
+                previous->changed = true;
+                Clay_RenderCommandArray_Add(&diff->modified, renderCommands->internalArray[i]);
+                Clay_RenderCommandArray_Add(&diff->previousModified, context->previousRenderCommands.internalArray[previousIndex]);
+            }
+        }
+        // Only the slots that were filled are emptied, so that the cost depends on the number of commands rather than the capacity
+        for (int32_t i = 0; i < previousSnapshots->length; ++i) {
+            Clay__RenderCommandSnapshot *previous = &previousSnapshots->internalArray[i];
+            if (previous->hashMapSlot != -1) {
+                hashMap->internalArray[previous->hashMapSlot] = 0;
+            }
+            if (!previous->matched) {
+                previous->changed = true;
+                Clay_RenderCommandArray_Add(&diff->removed, context->previousRenderCommands.internalArray[i]);
+            }
+        }
+    }
+
+    if (!unchanged && context->damageTrackingEnabled) {
+        Clay__CalculateDamageRectangles(context);
+    }
+    for (int32_t i = 0; i < renderCommands->length; ++i) {
+        context->previousRenderCommands.internalArray[i] = renderCommands->internalArray[i];
+    }
+    context->previousRenderCommands.length = renderCommands->length;
+    Clay__RenderCommandSnapshotArray currentSnapshots = *snapshots;
+    *snapshots = *previousSnapshots;
+    *previousSnapshots = currentSnapshots;
+    context->renderCommandSnapshotsValid = true;
+}
+
 CLAY_WASM_EXPORT("Clay_BeginLayout")
 void Clay_BeginLayout(void) {
     Clay_Context* context = Clay_GetCurrentContext();
     Clay__InitializeEphemeralMemory(context);
+    context->hitTestBoundsValid = false;
     context->generation++;
     context->dynamicElementIndex = 0;
+    context->layoutInputHash = 0xcbf29ce484222325ULL;
     // Set up the root container that covers the entire window
     Clay_Dimensions rootDimensions = {context->layoutDimensions.width, context->layoutDimensions.height};
     if (context->debugModeEnabled) {
@@ -4230,6 +6517,60 @@ void Clay_BeginLayout(void) {
     });
     Clay__int32_tArray_Add(&context->openLayoutElementStack, 0);
     Clay__LayoutElementTreeRootArray_Add(&context->layoutElementTreeRoots, CLAY__INIT(Clay__LayoutElementTreeRoot) { .layoutElementIndex = 0 });
+    context->profileFrame = CLAY__INIT(Clay_ProfileFrame) CLAY__DEFAULT_STRUCT;
+    CLAY_PROFILE_BEGIN(CLAY_PROFILE_PHASE_DECLARATION);
+}
+
+// Fills in the lengths and capacities of the arrays in the memory stats. The high water marks and counters are left as they are.
+Clay_MemoryStats Clay__ReadMemoryStats(Clay_Context *context) {
+    Clay_MemoryStats stats = context->memoryStats;
+    #define CLAY__READ_ARRAY_STATS(stat, array, unused) stats.stat.length = (array).length - (unused); stats.stat.capacity = (array).capacity;
+    CLAY__READ_ARRAY_STATS(layoutElements, context->layoutElements, 0)
+    CLAY__READ_ARRAY_STATS(renderCommands, context->renderCommands, 0)
+    CLAY__READ_ARRAY_STATS(elementConfigs, context->elementConfigs, 0)
+    CLAY__READ_ARRAY_STATS(elementConfigBytes, context->elementConfigPool, 0)
+    CLAY__READ_ARRAY_STATS(textElements, context->textElementData, 0)
+    CLAY__READ_ARRAY_STATS(wrappedTextLines, context->wrappedTextLines, 0)
+    CLAY__READ_ARRAY_STATS(treeRoots, context->layoutElementTreeRoots, 0)
+    CLAY__READ_ARRAY_STATS(debugStringBytes, context->dynamicStringData, 0)
+    CLAY__READ_ARRAY_STATS(elementIds, context->layoutElementsHashMapInternal, 0)
+    // Item 0 of the measure text cache is reserved, and removed items are reused from the free lists
+    CLAY__READ_ARRAY_STATS(measureTextCacheItems, context->measureTextHashMapInternal, CLAY__MIN(context->measureTextHashMapInternal.length, 1) + context->measureTextHashMapInternalFreeList.length)
+    CLAY__READ_ARRAY_STATS(measuredWords, context->measuredWords, context->measuredWordsFreeList.length)
+    CLAY__READ_ARRAY_STATS(wrappedLineCache, context->cachedWrappedLines, context->cachedWrappedLinesFreeList.length)
+    CLAY__READ_ARRAY_STATS(scrollContainers, context->scrollContainerDatas, 0)
+    CLAY__READ_ARRAY_STATS(pointerOverIds, context->pointerOverIds, 0)
+    CLAY__READ_ARRAY_STATS(fontMetrics, context->fontMetrics, 0)
+    #undef CLAY__READ_ARRAY_STATS
+    stats.arenaBytesUsed = context->internalArena.nextAllocation;
+    stats.arenaBytesReserved = context->internalArena.capacity;
+    stats.arenaBytesCommitted = context->internalArena.capacity;
+    if (context->arenaMemoryFunctions.commitFunction) {
+        stats.arenaBytesCommitted = context->internalArena.nextAllocation;
+        for (int32_t i = 0; i < context->growableArrays.length; ++i) {
+            Clay__GrowableArray *array = &context->growableArrays.internalArray[i];
+            stats.arenaBytesCommitted -= (size_t)(array->maxCapacity - *array->capacity) * array->itemSize;
+        }
+    }
+    return stats;
+}
+
+// Updates the high water marks and counters in the memory stats at the end of a layout
+void Clay__UpdateMemoryStats(Clay_Context *context) {
+    Clay_MemoryStats stats = Clay__ReadMemoryStats(context);
+    Clay_ArrayStats *arrays[] = {
+        &stats.layoutElements, &stats.renderCommands, &stats.elementConfigs, &stats.elementConfigBytes, &stats.textElements,
+        &stats.wrappedTextLines, &stats.treeRoots, &stats.debugStringBytes, &stats.elementIds, &stats.measureTextCacheItems,
+        &stats.measuredWords, &stats.wrappedLineCache, &stats.scrollContainers, &stats.pointerOverIds, &stats.fontMetrics,
+    };
+    for (int32_t i = 0; i < (int32_t)(sizeof(arrays) / sizeof(arrays[0])); ++i) {
+        arrays[i]->highWaterMark = CLAY__MAX(arrays[i]->highWaterMark, arrays[i]->length);
+    }
+    stats.layoutCount++;
+    if (context->booleanWarnings.maxElementsExceeded) {
+        stats.capacityExceededCount++;
+    }
+    context->memoryStats = stats;
 }
 
 CLAY_WASM_EXPORT("Clay_EndLayout")
@@ -4238,9 +6579,14 @@ Clay_RenderCommandArray Clay_EndLayout(void) {
     Clay__CloseElement();
     bool elementsExceededBeforeDebugView = context->booleanWarnings.maxElementsExceeded;
     if (context->debugModeEnabled && !elementsExceededBeforeDebugView) {
+        // The debug view reads the size of its contents while declaring them, so everything declared so far is measured first,
+        // and the debug view's own text is measured immediately
+        Clay__MeasurePendingText();
+        context->textMeasurementBatchingPaused = true;
         context->warningsEnabled = false;
         Clay__RenderDebugView();
         context->warningsEnabled = true;
+        context->textMeasurementBatchingPaused = false;
     }
     if (context->booleanWarnings.maxElementsExceeded) {
         Clay_String message;
@@ -4261,7 +6607,35 @@ Clay_RenderCommandArray Clay_EndLayout(void) {
                 .errorText = CLAY_STRING("There were still open layout elements when EndLayout was called. This results from an unequal number of calls to Clay__OpenElement and Clay__CloseElement."),
                 .userData = context->errorHandler.userData });
     }
-    Clay__CalculateFinalLayout();
+    CLAY_PROFILE_END(CLAY_PROFILE_PHASE_DECLARATION, context->layoutElements.length);
+    Clay__MeasurePendingText();
+    // Elements that were declared after running out of capacity are missing, and the ones that were open at the time were never
+    // closed, so the layout can't be calculated and only the error message is rendered
+    bool layoutCacheHit = false;
+    // Settings that change the output without changing any declaration are folded in once, so both cache functions see the same hash
+    Clay__HashLayoutInput(context, context->disableCulling);
+    Clay__HashLayoutInput(context, context->subtreeCullingEnabled);
+    if (!context->booleanWarnings.maxElementsExceeded) {
+        layoutCacheHit = Clay__LayoutCacheHit(context);
+        if (layoutCacheHit) {
+            Clay__RestoreCachedLayout(context);
+        } else {
+            Clay__CalculateFinalLayout();
+            if (context->layoutCachingEnabled) {
+                Clay__StoreCachedLayout(context);
+            }
+        }
+    }
+    if (context->renderCommandDiffingEnabled || context->damageTrackingEnabled) {
+        Clay__DiffRenderCommands(context, layoutCacheHit);
+    }
+    context->hitTestBoundsValid = true;
+    Clay__UpdateMemoryStats(context);
+    #ifdef CLAY_PROFILE
+    if (context->profileFunction) {
+        context->profileFunction(&context->profileFrame, context->profileUserData);
+    }
+    #endif
     return context->renderCommands;
 }
 
@@ -4302,9 +6676,9 @@ void Clay_OnHover(void (*onHoverFunction)(Clay_ElementId elementId, Clay_Pointer
     if (openLayoutElement->id == 0) {
         Clay__GenerateIdForAnonymousElement(openLayoutElement);
     }
-    Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(openLayoutElement->id);
-    hashMapItem->onHoverFunction = onHoverFunction;
-    hashMapItem->hoverFunctionUserData = userData;
+    Clay__LayoutElementHashMapItemColdData *coldData = Clay__GetHashMapItemColdData(Clay__GetHashMapItem(openLayoutElement->id));
+    coldData->onHoverFunction = onHoverFunction;
+    coldData->hoverFunctionUserData = userData;
 }
 
 CLAY_WASM_EXPORT("Clay_PointerOver")
@@ -4371,6 +6745,75 @@ void Clay_SetCullingEnabled(bool enabled) {
     context->disableCulling = !enabled;
 }
 
+CLAY_WASM_EXPORT("Clay_SetSubtreeCullingEnabled")
+void Clay_SetSubtreeCullingEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->subtreeCullingEnabled = enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_GetCullingStats")
+Clay_CullingStats Clay_GetCullingStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->cullingStats;
+}
+
+CLAY_WASM_EXPORT("Clay_SetLayoutCachingEnabled")
+void Clay_SetLayoutCachingEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->layoutCachingEnabled = enabled;
+    context->layoutCacheValid = false;
+}
+
+// Reports an error, once rather than every frame, if the context was initialized without memory for comparing render commands
+bool Clay__ValidateRenderCommandSnapshotMemory(Clay_Context *context) {
+    if (context->renderCommandSnapshots.capacity == 0) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Render command diffing and damage tracking need memory that is only allocated if Clay_SetArrayCapacities() is called with a .diffedRenderCommands before initialization."),
+            .userData = context->errorHandler.userData });
+        return false;
+    }
+    return true;
+}
+
+CLAY_WASM_EXPORT("Clay_SetRenderCommandDiffingEnabled")
+void Clay_SetRenderCommandDiffingEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (enabled && !Clay__ValidateRenderCommandSnapshotMemory(context)) {
+        return;
+    }
+    // Commands aren't stored while diffing is disabled, so the next frame can't be compared
+    if (!context->renderCommandDiffingEnabled && !context->damageTrackingEnabled) {
+        context->renderCommandSnapshotsValid = false;
+    }
+    context->renderCommandDiffingEnabled = enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_SetDamageTrackingEnabled")
+void Clay_SetDamageTrackingEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (enabled && !Clay__ValidateRenderCommandSnapshotMemory(context)) {
+        return;
+    }
+    // The first frame damages the entire layout, since it can't be compared with anything
+    if (!context->damageTrackingEnabled) {
+        context->renderCommandSnapshotsValid = false;
+    }
+    context->damageTrackingEnabled = enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_GetDamageRectangles")
+Clay_BoundingBoxArray Clay_GetDamageRectangles(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->damageRectangles;
+}
+
+CLAY_WASM_EXPORT("Clay_GetRenderCommandDiff")
+Clay_RenderCommandDiff Clay_GetRenderCommandDiff(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->renderCommandDiff;
+}
+
 CLAY_WASM_EXPORT("Clay_SetExternalScrollHandlingEnabled")
 void Clay_SetExternalScrollHandlingEnabled(bool enabled) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4386,8 +6829,18 @@ int32_t Clay_GetMaxElementCount(void) {
 CLAY_WASM_EXPORT("Clay_SetMaxElementCount")
 void Clay_SetMaxElementCount(int32_t maxElementCount) {
     Clay_Context* context = Clay_GetCurrentContext();
+    // A growable arena's arrays are laid out in its reserved address space when it's initialized, and can't be resized
+    if (context && context->arenaMemoryFunctions.commitFunction) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay_SetMaxElementCount() can't change a context created with Clay_InitializeGrowable(). Initialize a new context instead."),
+            .userData = context->errorHandler.userData });
+        return;
+    }
     if (context) {
         context->maxElementCount = maxElementCount;
+        // The next layout moves the ephemeral memory, including the render commands that a cache hit would reuse
+        context->layoutCacheValid = false;
     } else {
         Clay__defaultMaxElementCount = maxElementCount; // TODO: Fix this
         Clay__defaultMaxMeasureTextWordCacheCount = maxElementCount * 2;
@@ -4403,13 +6856,102 @@ int32_t Clay_GetMaxMeasureTextCacheWordCount(void) {
 CLAY_WASM_EXPORT("Clay_SetMaxMeasureTextCacheWordCount")
 void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount) {
     Clay_Context* context = Clay_GetCurrentContext();
+    if (context && context->arenaMemoryFunctions.commitFunction) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay_SetMaxMeasureTextCacheWordCount() can't change a context created with Clay_InitializeGrowable(). Initialize a new context instead."),
+            .userData = context->errorHandler.userData });
+        return;
+    }
     if (context) {
         Clay__currentContext->maxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount;
+        context->layoutCacheValid = false;
     } else {
         Clay__defaultMaxMeasureTextWordCacheCount = maxMeasureTextCacheWordCount; // TODO: Fix this
     }
 }
 
+CLAY_WASM_EXPORT("Clay_GetArrayCapacities")
+Clay_ArrayCapacities Clay_GetArrayCapacities(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context) {
+        return Clay__ResolveArrayCapacities(context->arrayCapacities, context->maxElementCount);
+    }
+    return Clay__ResolveArrayCapacities(Clay__defaultArrayCapacities, Clay__defaultMaxElementCount);
+}
+
+CLAY_WASM_EXPORT("Clay_SetArrayCapacities")
+void Clay_SetArrayCapacities(Clay_ArrayCapacities capacities) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context && context->arenaMemoryFunctions.commitFunction) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay_SetArrayCapacities() can't change a context created with Clay_InitializeGrowable(). Initialize a new context instead."),
+            .userData = context->errorHandler.userData });
+        return;
+    }
+    if (context) {
+        // The copies of render commands compared by diffing are persistent, so only the ephemeral arrays can be resized
+        capacities.diffedRenderCommands = context->arrayCapacities.diffedRenderCommands;
+        Clay_Context fakeContext = {
+            .maxElementCount = context->maxElementCount,
+            .maxMeasureTextCacheWordCount = context->maxMeasureTextCacheWordCount,
+            .arrayCapacities = capacities,
+            .internalArena = {
+                .nextAllocation = context->arenaResetOffset,
+                .capacity = SIZE_MAX,
+                .memory = NULL,
+            }
+        };
+        Clay__InitializeEphemeralMemory(&fakeContext);
+        if (fakeContext.internalArena.nextAllocation > context->internalArena.capacity) {
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+                .errorText = CLAY_STRING("Clay_SetArrayCapacities() was called with capacities that don't fit in the current context's arena. Initialize a new context with a larger arena instead."),
+                .userData = context->errorHandler.userData });
+            return;
+        }
+        context->arrayCapacities = capacities;
+        // The next layout moves the ephemeral memory, including the render commands that a cache hit would reuse
+        context->layoutCacheValid = false;
+    } else {
+        Clay__defaultArrayCapacities = capacities;
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_GetArrayHighWaterMarks")
+Clay_ArrayCapacities Clay_GetArrayHighWaterMarks(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_MemoryStats *stats = &context->memoryStats;
+    return CLAY__INIT(Clay_ArrayCapacities) {
+        .elementConfigs = stats->elementConfigs.highWaterMark,
+        .elementConfigBytes = stats->elementConfigBytes.highWaterMark,
+        .textElements = stats->textElements.highWaterMark,
+        .wrappedTextLines = stats->wrappedTextLines.highWaterMark,
+        .debugStringBytes = stats->debugStringBytes.highWaterMark,
+        // Left at 0 if the memory for diffing wasn't allocated, so that passing the result back doesn't allocate it
+        .diffedRenderCommands = context->arrayCapacities.diffedRenderCommands > 0 ? stats->renderCommands.highWaterMark : 0,
+    };
+}
+
+CLAY_WASM_EXPORT("Clay_GetMemoryStats")
+Clay_MemoryStats Clay_GetMemoryStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return Clay__ReadMemoryStats(context);
+}
+
+CLAY_WASM_EXPORT("Clay_ResetMemoryStats")
+void Clay_ResetMemoryStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->memoryStats = CLAY__INIT(Clay_MemoryStats) CLAY__DEFAULT_STRUCT;
+}
+
+CLAY_WASM_EXPORT("Clay_GetProfileFrame")
+Clay_ProfileFrame Clay_GetProfileFrame(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->profileFrame;
+}
+
 CLAY_WASM_EXPORT("Clay_ResetMeasureTextCache")
 void Clay_ResetMeasureTextCache(void) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4418,11 +6960,74 @@ void Clay_ResetMeasureTextCache(void) {
     context->measureTextHashMap.length = 0;
     context->measuredWords.length = 0;
     context->measuredWordsFreeList.length = 0;
+    context->cachedWrappedLines.length = 0;
+    context->cachedWrappedLinesFreeList.length = 0;
+    context->pendingTextMeasurements.length = 0;
+    context->fontMetrics.length = 0;
+    context->fontMetricsCacheStats = CLAY__INIT(Clay_FontMetricsCacheStats) CLAY__DEFAULT_STRUCT;
     
     for (int32_t i = 0; i < context->measureTextHashMap.capacity; ++i) {
         context->measureTextHashMap.internalArray[i] = 0;
     }
     context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    context->layoutCacheValid = false;
+}
+
+Clay_FontMetricsCacheStats Clay_GetFontMetricsCacheStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->fontMetricsCacheStats;
+}
+
+void Clay__InitializeSharedMeasureTextCacheMemory(Clay_SharedMeasureTextCache *cache, int32_t maxWordCount, Clay_Arena *arena) {
+    cache->maxWordCount = maxWordCount;
+    cache->itemCapacity = 16;
+    while (cache->itemCapacity < maxWordCount / 2) {
+        cache->itemCapacity *= 2;
+    }
+    cache->itemIds = (volatile uint32_t *)Clay__Array_Allocate_Arena(cache->itemCapacity, sizeof(uint32_t), arena);
+    cache->itemStates = (volatile uint32_t *)Clay__Array_Allocate_Arena(cache->itemCapacity, sizeof(uint32_t), arena);
+    cache->items = (Clay__MeasureTextCacheItem *)Clay__Array_Allocate_Arena(cache->itemCapacity, sizeof(Clay__MeasureTextCacheItem), arena);
+    cache->measuredWords = (Clay__MeasuredWord *)Clay__Array_Allocate_Arena(maxWordCount, sizeof(Clay__MeasuredWord), arena);
+}
+
+CLAY_WASM_EXPORT("Clay_MinSharedMeasureTextCacheMemorySize")
+uint32_t Clay_MinSharedMeasureTextCacheMemorySize(int32_t maxWordCount) {
+    Clay_SharedMeasureTextCache fakeCache = CLAY__DEFAULT_STRUCT;
+    Clay_Arena fakeArena = { .nextAllocation = sizeof(Clay_SharedMeasureTextCache), .capacity = SIZE_MAX, .memory = NULL };
+    Clay__InitializeSharedMeasureTextCacheMemory(&fakeCache, maxWordCount, &fakeArena);
+    return (uint32_t)fakeArena.nextAllocation + 128;
+}
+
+CLAY_WASM_EXPORT("Clay_InitializeSharedMeasureTextCache")
+Clay_SharedMeasureTextCache* Clay_InitializeSharedMeasureTextCache(Clay_Arena arena, int32_t maxWordCount) {
+    if (arena.capacity < Clay_MinSharedMeasureTextCacheMemorySize(maxWordCount)) {
+        return NULL;
+    }
+    // Cacheline align memory passed in
+    uintptr_t baseOffset = 64 - ((uintptr_t)arena.memory % 64);
+    baseOffset = baseOffset == 64 ? 0 : baseOffset;
+    arena.memory += baseOffset;
+    Clay_SharedMeasureTextCache *cache = (Clay_SharedMeasureTextCache *)arena.memory;
+    arena.nextAllocation = sizeof(Clay_SharedMeasureTextCache);
+    *cache = CLAY__INIT(Clay_SharedMeasureTextCache) CLAY__DEFAULT_STRUCT;
+    Clay__InitializeSharedMeasureTextCacheMemory(cache, maxWordCount, &arena);
+    Clay_ResetSharedMeasureTextCache(cache);
+    return cache;
+}
+
+CLAY_WASM_EXPORT("Clay_SetSharedMeasureTextCache")
+void Clay_SetSharedMeasureTextCache(Clay_SharedMeasureTextCache *cache) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->sharedMeasureTextCache = cache;
+}
+
+CLAY_WASM_EXPORT("Clay_ResetSharedMeasureTextCache")
+void Clay_ResetSharedMeasureTextCache(Clay_SharedMeasureTextCache *cache) {
+    for (int32_t i = 0; i < cache->itemCapacity; ++i) {
+        cache->itemIds[i] = 0;
+        cache->itemStates[i] = CLAY__SHARED_MEASUREMENT_STATE_PENDING;
+    }
+    cache->measuredWordCount = 0;
 }
 
 #endif // CLAY_IMPLEMENTATION
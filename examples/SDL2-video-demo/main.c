@@ -163,6 +163,7 @@ int main(int argc, char *argv[]) {
     }
 
 quit:
+    Clay_SDL2_ClearTextCache();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     IMG_Quit();
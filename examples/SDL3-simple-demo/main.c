@@ -209,6 +209,8 @@ void SDL_AppQuit(void *appstate, SDL_AppResult result)
     }
 
     if (state) {
+        SDL_Clay_DestroyRendererData(&state->rendererData);
+
         if (state->rendererData.renderer)
             SDL_DestroyRenderer(state->rendererData.renderer);
 
@@ -42,7 +42,37 @@ void RenderDropdownTextItem(int index) {
     }
 }
 
+// A dense grid of 10,000 cells with a mix of rounded corners and borders, toggled with S, to compare rendering with and without batching (B)
+#define STRESS_TEST_ROWS 100
+#define STRESS_TEST_COLUMNS 100
+bool stressTestEnabled = false;
+bool batchingEnabled = true;
+
+Clay_RenderCommandArray CreateStressTestLayout(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("StressTestOuter"), { .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .padding = { 8, 8, 8, 8 }, .childGap = 1 }, .backgroundColor = {200, 200, 200, 255} }) {
+        CLAY_TEXT(batchingEnabled ? CLAY_STRING("10,000 elements, batched (S to exit, B to toggle batching)") : CLAY_STRING("10,000 elements, not batched (S to exit, B to toggle batching)"), CLAY_TEXT_CONFIG({ .fontSize = 16, .textColor = {0, 0, 0, 255} }));
+        for (int row = 0; row < STRESS_TEST_ROWS; row++) {
+            CLAY(CLAY_IDI("StressTestRow", row), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .childGap = 1 } }) {
+                for (int column = 0; column < STRESS_TEST_COLUMNS; column++) {
+                    int index = row * STRESS_TEST_COLUMNS + column;
+                    CLAY(CLAY_IDI("StressTestCell", index), {
+                        .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) } },
+                        .backgroundColor = { 100 + (column * 5) % 155, 100 + (row * 5) % 155, 180, 255 },
+                        .cornerRadius = CLAY_CORNER_RADIUS(index % 3 == 0 ? 3 : 0),
+                        .border = { .width = CLAY_BORDER_OUTSIDE(index % 5 == 0 ? 1 : 0), .color = {60, 60, 60, 255} },
+                    }) {}
+                }
+            }
+        }
+    }
+    return Clay_EndLayout();
+}
+
 Clay_RenderCommandArray CreateLayout(void) {
+    if (stressTestEnabled) {
+        return CreateStressTestLayout();
+    }
     Clay_BeginLayout();
     CLAY(CLAY_ID("OuterContainer"), { .layout = { .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_GROW(0) }, .padding = { 16, 16, 16, 16 }, .childGap = 16 }, .backgroundColor = {200, 200, 200, 255} }) {
         CLAY(CLAY_ID("SideBar"), { .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = { .width = CLAY_SIZING_FIXED(300), .height = CLAY_SIZING_GROW(0) }, .padding = {16, 16, 16, 16 }, .childGap = 16 }, .backgroundColor = {150, 150, 255, 255} }) {
@@ -163,6 +193,13 @@ void UpdateDrawFrame(Font* fonts)
         debugEnabled = !debugEnabled;
         Clay_SetDebugModeEnabled(debugEnabled);
     }
+    if (IsKeyPressed(KEY_S)) {
+        stressTestEnabled = !stressTestEnabled;
+    }
+    if (IsKeyPressed(KEY_B)) {
+        batchingEnabled = !batchingEnabled;
+        Clay_Raylib_SetBatchingEnabled(batchingEnabled);
+    }
     //----------------------------------------------------------------------------------
     // Handle scroll containers
     Clay_Vector2 mousePosition = RAYLIB_VECTOR2_TO_CLAY_VECTOR2(GetMousePosition());
@@ -199,12 +236,12 @@ void UpdateDrawFrame(Font* fonts)
     Clay_RenderCommandArray renderCommands = CreateLayout();
     printf("layout time: %f microseconds\n", (GetTime() - currentTime) * 1000 * 1000);
     // RENDERING ---------------------------------
-//    currentTime = GetTime();
+    currentTime = GetTime();
     BeginDrawing();
     ClearBackground(BLACK);
     Clay_Raylib_Render(renderCommands, fonts);
     EndDrawing();
-//    printf("render time: %f ms\n", (GetTime() - currentTime) * 1000);
+    printf("render time: %f ms, frame time: %f ms\n", (GetTime() - currentTime) * 1000, GetFrameTime() * 1000);
 
     //----------------------------------------------------------------------------------
 }
@@ -242,7 +279,6 @@ int main(void) {
     while (!WindowShouldClose())    // Detect window close button or ESC key
     {
         if (reinitializeClay) {
-            Clay_SetMaxElementCount(8192);
             totalMemorySize = Clay_MinMemorySize();
             clayMemory = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
             Clay_Initialize(clayMemory, (Clay_Dimensions) { (float)GetScreenWidth(), (float)GetScreenHeight() }, (Clay_ErrorHandler) { HandleClayErrors, 0 });
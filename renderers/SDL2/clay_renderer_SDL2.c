@@ -39,6 +39,166 @@ static Clay_Dimensions SDL2_MeasureText(Clay_StringSlice text, Clay_TextElementC
     };
 }
 
+/* Rendered text is cached as textures, so that text which doesn't change between frames is only rasterized and uploaded once.
+ * The cache is an open addressing hash table keyed by the text's contents, font, size and color. Textures that haven't been
+ * drawn for CLAY_SDL2_TEXT_CACHE_MAX_AGE frames are destroyed, as are the least recently drawn ones when the cache holds more
+ * than CLAY_SDL2_TEXT_CACHE_BUDGET bytes of texture data or is too full. */
+#ifndef CLAY_SDL2_TEXT_CACHE_CAPACITY
+    #define CLAY_SDL2_TEXT_CACHE_CAPACITY 1024 // Must be a power of two
+#endif
+#ifndef CLAY_SDL2_TEXT_CACHE_BUDGET
+    #define CLAY_SDL2_TEXT_CACHE_BUDGET (64 * 1024 * 1024)
+#endif
+#ifndef CLAY_SDL2_TEXT_CACHE_MAX_AGE
+    #define CLAY_SDL2_TEXT_CACHE_MAX_AGE 120
+#endif
+
+typedef struct
+{
+    uint64_t key; // 0 for an empty slot
+    SDL_Texture *texture;
+    size_t bytes;
+    uint32_t lastUsedFrame;
+} SDL2_TextCacheEntry;
+
+static SDL2_TextCacheEntry textCache[CLAY_SDL2_TEXT_CACHE_CAPACITY];
+static int32_t textCacheCount = 0;
+static size_t textCacheBytes = 0;
+static uint32_t textCacheFrame = 0;
+static SDL_Renderer *textCacheRenderer = NULL; // Textures can only be drawn by the renderer that created them
+
+static uint64_t SDL2_TextCacheKey(Clay_TextRenderData *config)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int32_t i = 0; i < config->stringContents.length; i++) {
+        hash = (hash ^ (uint8_t)config->stringContents.chars[i]) * 0x100000001b3ULL;
+    }
+    uint64_t style = (uint64_t)config->fontId | (uint64_t)config->fontSize << 16 | (uint64_t)config->stringContents.length << 32;
+    uint32_t color = (uint32_t)(Uint8)config->textColor.r | (uint32_t)(Uint8)config->textColor.g << 8 | (uint32_t)(Uint8)config->textColor.b << 16 | (uint32_t)(Uint8)config->textColor.a << 24;
+    hash = (hash ^ style) * 0x100000001b3ULL;
+    hash = (hash ^ color) * 0x100000001b3ULL;
+    return hash ? hash : 1;
+}
+
+static void SDL2_RemoveTextCacheEntry(int32_t slot)
+{
+    SDL_DestroyTexture(textCache[slot].texture);
+    textCacheBytes -= textCache[slot].bytes;
+    textCacheCount--;
+    textCache[slot].key = 0;
+    // Shift back any entries that were displaced past the removed one, so that lookups never need to skip holes
+    int32_t mask = CLAY_SDL2_TEXT_CACHE_CAPACITY - 1;
+    int32_t hole = slot;
+    for (int32_t next = (slot + 1) & mask; textCache[next].key != 0; next = (next + 1) & mask) {
+        int32_t home = (int32_t)(textCache[next].key & mask);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            textCache[hole] = textCache[next];
+            textCache[next].key = 0;
+            hole = next;
+        }
+    }
+}
+
+static void SDL2_EvictLeastRecentlyUsedText(void)
+{
+    int32_t oldestSlot = -1;
+    for (int32_t slot = 0; slot < CLAY_SDL2_TEXT_CACHE_CAPACITY; slot++) {
+        // Textures drawn this frame are still needed
+        if (textCache[slot].key != 0 && textCache[slot].lastUsedFrame != textCacheFrame && (oldestSlot == -1 || textCache[slot].lastUsedFrame < textCache[oldestSlot].lastUsedFrame)) {
+            oldestSlot = slot;
+        }
+    }
+    if (oldestSlot != -1) {
+        SDL2_RemoveTextCacheEntry(oldestSlot);
+    }
+}
+
+/* Destroys every cached text texture. Call this before destroying the renderer, or after changing the fonts. */
+static void Clay_SDL2_ClearTextCache(void)
+{
+    for (int32_t slot = 0; slot < CLAY_SDL2_TEXT_CACHE_CAPACITY; slot++) {
+        if (textCache[slot].key != 0) {
+            SDL_DestroyTexture(textCache[slot].texture);
+            textCache[slot].key = 0;
+        }
+    }
+    textCacheCount = 0;
+    textCacheBytes = 0;
+}
+
+static void SDL2_BeginTextCacheFrame(SDL_Renderer *renderer)
+{
+    if (renderer != textCacheRenderer) {
+        Clay_SDL2_ClearTextCache();
+        textCacheRenderer = renderer;
+    }
+    textCacheFrame++;
+    for (int32_t slot = 0; slot < CLAY_SDL2_TEXT_CACHE_CAPACITY; slot++) {
+        if (textCache[slot].key != 0 && textCacheFrame - textCache[slot].lastUsedFrame > CLAY_SDL2_TEXT_CACHE_MAX_AGE) {
+            SDL2_RemoveTextCacheEntry(slot);
+            slot--; // Another entry may have been shifted back into this slot
+        }
+    }
+}
+
+/* Returns the texture for the text, rendering and caching it if it isn't already cached.
+ * If the cache has no room for it, *temporary is set to true and the caller must destroy the texture once it has been drawn. */
+static SDL_Texture *SDL2_GetTextTexture(SDL_Renderer *renderer, Clay_TextRenderData *config, SDL2_Font *fonts, bool *temporary)
+{
+    *temporary = false;
+    uint64_t key = SDL2_TextCacheKey(config);
+    int32_t mask = CLAY_SDL2_TEXT_CACHE_CAPACITY - 1;
+    int32_t slot = (int32_t)(key & mask);
+    while (textCache[slot].key != 0) {
+        if (textCache[slot].key == key) {
+            textCache[slot].lastUsedFrame = textCacheFrame;
+            return textCache[slot].texture;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    char *cloned = (char *)calloc(config->stringContents.length + 1, 1);
+    memcpy(cloned, config->stringContents.chars, config->stringContents.length);
+    TTF_Font* font = fonts[config->fontId].font;
+    TTF_SetFontSize(font, config->fontSize);
+    SDL_Surface *surface = TTF_RenderUTF8_Blended(font, cloned, (SDL_Color) {
+            .r = (Uint8)config->textColor.r,
+            .g = (Uint8)config->textColor.g,
+            .b = (Uint8)config->textColor.b,
+            .a = (Uint8)config->textColor.a,
+    });
+    free(cloned);
+    if (!surface) {
+        return NULL;
+    }
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    size_t bytes = (size_t)surface->w * (size_t)surface->h * 4;
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        return NULL;
+    }
+
+    // Keep the table at most three quarters full so that probes stay short
+    int32_t previousCount = -1;
+    while ((textCacheCount >= CLAY_SDL2_TEXT_CACHE_CAPACITY * 3 / 4 || textCacheBytes + bytes > CLAY_SDL2_TEXT_CACHE_BUDGET) && textCacheCount != previousCount) {
+        previousCount = textCacheCount;
+        SDL2_EvictLeastRecentlyUsedText();
+    }
+    if (textCacheCount >= CLAY_SDL2_TEXT_CACHE_CAPACITY * 3 / 4) {
+        // Everything in the cache was drawn this frame, so this texture isn't kept
+        *temporary = true;
+        return texture;
+    }
+    slot = (int32_t)(key & mask);
+    while (textCache[slot].key != 0) {
+        slot = (slot + 1) & mask;
+    }
+    textCache[slot] = (SDL2_TextCacheEntry) { .key = key, .texture = texture, .bytes = bytes, .lastUsedFrame = textCacheFrame };
+    textCacheCount++;
+    textCacheBytes += bytes;
+    return texture;
+}
+
 /* Global for convenience. Even in 4K this is enough for smooth curves (low radius or rect size coupled with
  * no AA or low resolution might make it appear as jagged curves) */
 static int NUM_CIRCLE_SEGMENTS = 16;
@@ -266,6 +426,7 @@ SDL_Rect currentClippingRectangle;
 
 static void Clay_SDL2_Render(SDL_Renderer *renderer, Clay_RenderCommandArray renderCommands, SDL2_Font *fonts)
 {
+    SDL2_BeginTextCacheFrame(renderer);
     for (uint32_t i = 0; i < renderCommands.length; i++)
     {
         Clay_RenderCommand *renderCommand = Clay_RenderCommandArray_Get(&renderCommands, i);
@@ -292,17 +453,11 @@ static void Clay_SDL2_Render(SDL_Renderer *renderer, Clay_RenderCommandArray ren
             }
             case CLAY_RENDER_COMMAND_TYPE_TEXT: {
                 Clay_TextRenderData *config = &renderCommand->renderData.text;
-                char *cloned = (char *)calloc(config->stringContents.length + 1, 1);
-                memcpy(cloned, config->stringContents.chars, config->stringContents.length);
-                TTF_Font* font = fonts[config->fontId].font;
-                TTF_SetFontSize(font, config->fontSize);
-                SDL_Surface *surface = TTF_RenderUTF8_Blended(font, cloned, (SDL_Color) {
-                        .r = (Uint8)config->textColor.r,
-                        .g = (Uint8)config->textColor.g,
-                        .b = (Uint8)config->textColor.b,
-                        .a = (Uint8)config->textColor.a,
-                });
-                SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+                bool temporary;
+                SDL_Texture *texture = SDL2_GetTextTexture(renderer, config, fonts, &temporary);
+                if (!texture) {
+                    break;
+                }
 
                 SDL_Rect destination = (SDL_Rect){
                         .x = boundingBox.x,
@@ -312,9 +467,9 @@ static void Clay_SDL2_Render(SDL_Renderer *renderer, Clay_RenderCommandArray ren
                 };
                 SDL_RenderCopy(renderer, texture, NULL, &destination);
 
-                SDL_DestroyTexture(texture);
-                SDL_FreeSurface(surface);
-                free(cloned);
+                if (temporary) {
+                    SDL_DestroyTexture(texture);
+                }
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
@@ -4,17 +4,162 @@
 #include <SDL3_ttf/SDL_ttf.h>
 #include <SDL3_image/SDL_image.h>
 
+/* Text objects that haven't been drawn for this many frames are destroyed */
+#ifndef CLAY_SDL3_TEXT_CACHE_MAX_AGE
+    #define CLAY_SDL3_TEXT_CACHE_MAX_AGE 60
+#endif
+
+/* A TTF_Text kept between frames for the text command with the same id */
+typedef struct {
+    uint32_t id; // 0 for an empty slot
+    uint64_t contentHash; // The string, font and size that the text was shaped with
+    TTF_Text *text;
+    uint32_t lastUsedFrame;
+} Clay_SDL3CachedText;
+
+/* A copy of one of the fonts at a fixed size, so that cached text never has to be shaped again because the size of its font changed */
+typedef struct {
+    uint16_t fontId;
+    uint16_t fontSize;
+    TTF_Font *font;
+} Clay_SDL3SizedFont;
+
+/* Text and images wait in the batch for at most this many draws before it is flushed */
+#ifndef CLAY_SDL3_MAX_DEFERRED_DRAWS
+    #define CLAY_SDL3_MAX_DEFERRED_DRAWS 256
+#endif
+
+/* A text or image command that is drawn after the shapes in the batch, which is only valid while no later shape overlaps it */
+typedef struct {
+    SDL_FRect bounds;
+    TTF_Text *text;
+    bool temporary; // The text isn't cached and is destroyed once it has been drawn
+    SDL_Texture *texture;
+} Clay_SDL3DeferredDraw;
+
+/* Vertices and indices of consecutive shapes, submitted together by a single SDL_RenderGeometry call */
+typedef struct {
+    SDL_Vertex *vertices;
+    int *indices;
+    int vertexCount;
+    int vertexCapacity;
+    int indexCount;
+    int indexCapacity;
+    Clay_SDL3DeferredDraw deferred[CLAY_SDL3_MAX_DEFERRED_DRAWS];
+    int deferredCount;
+} Clay_SDL3GeometryBatch;
+
 typedef struct {
     SDL_Renderer *renderer;
     TTF_TextEngine *textEngine;
     TTF_Font **fonts;
+    // Managed by the renderer. Zero initialize them, and release them with SDL_Clay_DestroyRendererData.
+    Clay_SDL3CachedText *textCache;
+    int textCacheCapacity; // A power of two
+    int textCacheCount;
+    uint32_t textCacheFrame;
+    Clay_SDL3SizedFont *sizedFonts;
+    int sizedFontCount;
+    Clay_SDL3GeometryBatch batch;
+    int drawCallCount; // Draw calls issued by the last SDL_Clay_RenderClayCommands
 } Clay_SDL3RendererData;
 
 /* Global for convenience. Even in 4K this is enough for smooth curves (low radius or rect size coupled with
  * no AA or low resolution might make it appear as jagged curves) */
 static int NUM_CIRCLE_SEGMENTS = 16;
 
-//all rendering is performed by a single SDL call, avoiding multiple RenderRect + plumbing choice for circles.
+/* Submits every shape batched since the last flush, followed by the deferred text and images. Called before the clip rect changes,
+ * or when a shape would otherwise be drawn over a deferred draw that comes before it. */
+static void SDL_Clay_FlushBatch(Clay_SDL3RendererData *rendererData) {
+    Clay_SDL3GeometryBatch *batch = &rendererData->batch;
+    if (batch->indexCount > 0) {
+        SDL_RenderGeometry(rendererData->renderer, NULL, batch->vertices, batch->vertexCount, batch->indices, batch->indexCount);
+        rendererData->drawCallCount++;
+    }
+    for (int i = 0; i < batch->deferredCount; i++) {
+        Clay_SDL3DeferredDraw *draw = &batch->deferred[i];
+        if (draw->text) {
+            TTF_DrawRendererText(draw->text, draw->bounds.x, draw->bounds.y);
+            if (draw->temporary) TTF_DestroyText(draw->text);
+        } else {
+            SDL_RenderTexture(rendererData->renderer, draw->texture, NULL, &draw->bounds);
+        }
+        rendererData->drawCallCount++;
+    }
+    batch->vertexCount = 0;
+    batch->indexCount = 0;
+    batch->deferredCount = 0;
+}
+
+/* Queues a text or image to be drawn after the batched shapes */
+static void SDL_Clay_DeferDraw(Clay_SDL3RendererData *rendererData, Clay_SDL3DeferredDraw draw) {
+    Clay_SDL3GeometryBatch *batch = &rendererData->batch;
+    if (batch->deferredCount == CLAY_SDL3_MAX_DEFERRED_DRAWS) {
+        SDL_Clay_FlushBatch(rendererData);
+    }
+    batch->deferred[batch->deferredCount++] = draw;
+}
+
+/* Flushes the batch if a shape in rect would cover a deferred draw, so that it still ends up on top of it */
+static void SDL_Clay_PrepareBatch(Clay_SDL3RendererData *rendererData, const SDL_FRect rect) {
+    Clay_SDL3GeometryBatch *batch = &rendererData->batch;
+    // Borders and arcs are drawn up to a pixel outside of their bounding box
+    const SDL_FRect shape = { rect.x - 1, rect.y - 1, rect.w + 2, rect.h + 2 };
+    for (int i = 0; i < batch->deferredCount; i++) {
+        const SDL_FRect *bounds = &batch->deferred[i].bounds;
+        if (shape.x < bounds->x + bounds->w && bounds->x < shape.x + shape.w && shape.y < bounds->y + bounds->h && bounds->y < shape.y + shape.h) {
+            SDL_Clay_FlushBatch(rendererData);
+            return;
+        }
+    }
+}
+
+/* Makes room in the batch for a shape, growing the buffers if needed. Returns false if the shape can't be drawn. */
+static bool SDL_Clay_ReserveBatch(Clay_SDL3RendererData *rendererData, int vertexCount, int indexCount) {
+    Clay_SDL3GeometryBatch *batch = &rendererData->batch;
+    if (batch->vertexCount + vertexCount > batch->vertexCapacity) {
+        int capacity = batch->vertexCapacity ? batch->vertexCapacity : 1024;
+        while (capacity < batch->vertexCount + vertexCount) capacity *= 2;
+        SDL_Vertex *vertices = SDL_realloc(batch->vertices, capacity * sizeof(SDL_Vertex));
+        if (!vertices) {
+            SDL_Clay_FlushBatch(rendererData);
+            return vertexCount <= batch->vertexCapacity && indexCount <= batch->indexCapacity;
+        }
+        batch->vertices = vertices;
+        batch->vertexCapacity = capacity;
+    }
+    if (batch->indexCount + indexCount > batch->indexCapacity) {
+        int capacity = batch->indexCapacity ? batch->indexCapacity : 1536;
+        while (capacity < batch->indexCount + indexCount) capacity *= 2;
+        int *indices = SDL_realloc(batch->indices, capacity * sizeof(int));
+        if (!indices) {
+            SDL_Clay_FlushBatch(rendererData);
+            return vertexCount <= batch->vertexCapacity && indexCount <= batch->indexCapacity;
+        }
+        batch->indices = indices;
+        batch->indexCapacity = capacity;
+    }
+    return true;
+}
+
+static void SDL_Clay_BatchFillRect(Clay_SDL3RendererData *rendererData, const SDL_FRect rect, const Clay_Color _color) {
+    if (rect.w <= 0 || rect.h <= 0 || !SDL_Clay_ReserveBatch(rendererData, 4, 6)) return;
+    const SDL_FColor color = { _color.r/255, _color.g/255, _color.b/255, _color.a/255 };
+    Clay_SDL3GeometryBatch *batch = &rendererData->batch;
+    const int base = batch->vertexCount;
+    SDL_Vertex *vertices = &batch->vertices[batch->vertexCount];
+    vertices[0] = (SDL_Vertex){ {rect.x, rect.y}, color, {0, 0} };
+    vertices[1] = (SDL_Vertex){ {rect.x + rect.w, rect.y}, color, {0, 0} };
+    vertices[2] = (SDL_Vertex){ {rect.x + rect.w, rect.y + rect.h}, color, {0, 0} };
+    vertices[3] = (SDL_Vertex){ {rect.x, rect.y + rect.h}, color, {0, 0} };
+    int *indices = &batch->indices[batch->indexCount];
+    indices[0] = base; indices[1] = base + 1; indices[2] = base + 3;
+    indices[3] = base + 1; indices[4] = base + 2; indices[5] = base + 3;
+    batch->vertexCount += 4;
+    batch->indexCount += 6;
+}
+
+//all geometry is added to the batch, avoiding multiple RenderRect + plumbing choice for circles.
 static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData, const SDL_FRect rect, const float cornerRadius, const Clay_Color _color) {
     const SDL_FColor color = { _color.r/255, _color.g/255, _color.b/255, _color.a/255 };
 
@@ -28,8 +173,10 @@ static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData,
     int totalVertices = 4 + (4 * (numCircleSegments * 2)) + 2*4;
     int totalIndices = 6 + (4 * (numCircleSegments * 3)) + 6*4;
 
-    SDL_Vertex vertices[totalVertices];
-    int indices[totalIndices];
+    if (!SDL_Clay_ReserveBatch(rendererData, totalVertices, totalIndices)) return;
+    Clay_SDL3GeometryBatch *batch = &rendererData->batch;
+    SDL_Vertex *vertices = &batch->vertices[batch->vertexCount];
+    int *indices = &batch->indices[batch->indexCount];
 
     //define center rectangle
     vertices[vertexCount++] = (SDL_Vertex){ {rect.x + clampedRadius, rect.y + clampedRadius}, color, {0, 0} }; //0 center TL
@@ -112,12 +259,17 @@ static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData,
     indices[indexCount++] = 3;
     indices[indexCount++] = vertexCount - 1; //LT
 
-    // Render everything
-    SDL_RenderGeometry(rendererData->renderer, NULL, vertices, vertexCount, indices, indexCount);
+    // Offset the indices to where the vertices landed in the batch
+    for (int i = 0; i < indexCount; i++) {
+        indices[i] += batch->vertexCount;
+    }
+    batch->vertexCount += vertexCount;
+    batch->indexCount += indexCount;
 }
 
-static void SDL_Clay_RenderArc(Clay_SDL3RendererData *rendererData, const SDL_FPoint center, const float radius, const float startAngle, const float endAngle, const float thickness, const Clay_Color color) {
-    SDL_SetRenderDrawColor(rendererData->renderer, color.r, color.g, color.b, color.a);
+/* Adds a ring segment to the batch, covering the band between radius and radius - thickness */
+static void SDL_Clay_RenderArc(Clay_SDL3RendererData *rendererData, const SDL_FPoint center, const float radius, const float startAngle, const float endAngle, const float thickness, const Clay_Color _color) {
+    const SDL_FColor color = { _color.r/255, _color.g/255, _color.b/255, _color.a/255 };
 
     const float radStart = startAngle * (SDL_PI_F / 180.0f);
     const float radEnd = endAngle * (SDL_PI_F / 180.0f);
@@ -125,26 +277,190 @@ static void SDL_Clay_RenderArc(Clay_SDL3RendererData *rendererData, const SDL_FP
     const int numCircleSegments = SDL_max(NUM_CIRCLE_SEGMENTS, (int)(radius * 1.5f)); //increase circle segments for larger circles, 1.5 is arbitrary.
 
     const float angleStep = (radEnd - radStart) / (float)numCircleSegments;
-    const float thicknessStep = 0.4f; //arbitrary value to avoid overlapping lines. Changing THICKNESS_STEP or numCircleSegments might cause artifacts.
+    const float innerRadius = SDL_max(radius - thickness, 0.0f);
+
+    if (thickness <= 0 || !SDL_Clay_ReserveBatch(rendererData, (numCircleSegments + 1) * 2, numCircleSegments * 6)) return;
+    Clay_SDL3GeometryBatch *batch = &rendererData->batch;
+    const int base = batch->vertexCount;
+    SDL_Vertex *vertices = &batch->vertices[batch->vertexCount];
+    int *indices = &batch->indices[batch->indexCount];
+
+    for (int i = 0; i <= numCircleSegments; i++) {
+        const float angle = radStart + i * angleStep;
+        const float cosAngle = SDL_cosf(angle), sinAngle = SDL_sinf(angle);
+        vertices[i * 2] = (SDL_Vertex){ {center.x + cosAngle * radius, center.y + sinAngle * radius}, color, {0, 0} };
+        vertices[i * 2 + 1] = (SDL_Vertex){ {center.x + cosAngle * innerRadius, center.y + sinAngle * innerRadius}, color, {0, 0} };
+    }
+    for (int i = 0; i < numCircleSegments; i++) {
+        const int outer = base + i * 2;
+        indices[i * 6 + 0] = outer;
+        indices[i * 6 + 1] = outer + 2;
+        indices[i * 6 + 2] = outer + 1;
+        indices[i * 6 + 3] = outer + 1;
+        indices[i * 6 + 4] = outer + 2;
+        indices[i * 6 + 5] = outer + 3;
+    }
+    batch->vertexCount += (numCircleSegments + 1) * 2;
+    batch->indexCount += numCircleSegments * 6;
+}
+
+static TTF_Font *SDL_Clay_GetSizedFont(Clay_SDL3RendererData *rendererData, uint16_t fontId, uint16_t fontSize) {
+    for (int i = 0; i < rendererData->sizedFontCount; i++) {
+        if (rendererData->sizedFonts[i].fontId == fontId && rendererData->sizedFonts[i].fontSize == fontSize) {
+            return rendererData->sizedFonts[i].font;
+        }
+    }
+    TTF_Font *font = TTF_CopyFont(rendererData->fonts[fontId]);
+    Clay_SDL3SizedFont *sizedFonts = SDL_realloc(rendererData->sizedFonts, (rendererData->sizedFontCount + 1) * sizeof(Clay_SDL3SizedFont));
+    if (!font || !sizedFonts) {
+        // Fall back to resizing the shared font, which reshapes any cached text that uses it
+        if (font) TTF_CloseFont(font);
+        if (sizedFonts) rendererData->sizedFonts = sizedFonts;
+        TTF_SetFontSize(rendererData->fonts[fontId], fontSize);
+        return rendererData->fonts[fontId];
+    }
+    TTF_SetFontSize(font, fontSize);
+    rendererData->sizedFonts = sizedFonts;
+    rendererData->sizedFonts[rendererData->sizedFontCount++] = (Clay_SDL3SizedFont) { fontId, fontSize, font };
+    return font;
+}
+
+static uint64_t SDL_Clay_TextContentHash(Clay_TextRenderData *config) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int32_t i = 0; i < config->stringContents.length; i++) {
+        hash = (hash ^ (uint8_t)config->stringContents.chars[i]) * 0x100000001b3ULL;
+    }
+    hash = (hash ^ ((uint64_t)config->fontId | (uint64_t)config->fontSize << 16 | (uint64_t)config->stringContents.length << 32)) * 0x100000001b3ULL;
+    return hash;
+}
+
+/* Removes a text from the open addressing table, shifting back any entries that were displaced past it */
+static void SDL_Clay_RemoveCachedText(Clay_SDL3RendererData *rendererData, int slot) {
+    Clay_SDL3CachedText *cache = rendererData->textCache;
+    const int mask = rendererData->textCacheCapacity - 1;
+    TTF_DestroyText(cache[slot].text);
+    cache[slot].id = 0;
+    rendererData->textCacheCount--;
+    int hole = slot;
+    for (int next = (slot + 1) & mask; cache[next].id != 0; next = (next + 1) & mask) {
+        const int home = (int)(cache[next].id & mask);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            cache[hole] = cache[next];
+            cache[next].id = 0;
+            hole = next;
+        }
+    }
+}
+
+static bool SDL_Clay_GrowTextCache(Clay_SDL3RendererData *rendererData) {
+    const int capacity = rendererData->textCacheCapacity ? rendererData->textCacheCapacity * 2 : 256;
+    Clay_SDL3CachedText *cache = SDL_calloc(capacity, sizeof(Clay_SDL3CachedText));
+    if (!cache) {
+        return false;
+    }
+    for (int i = 0; i < rendererData->textCacheCapacity; i++) {
+        if (rendererData->textCache[i].id != 0) {
+            int slot = (int)(rendererData->textCache[i].id & (capacity - 1));
+            while (cache[slot].id != 0) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            cache[slot] = rendererData->textCache[i];
+        }
+    }
+    SDL_free(rendererData->textCache);
+    rendererData->textCache = cache;
+    rendererData->textCacheCapacity = capacity;
+    return true;
+}
 
-    for (float t = thicknessStep; t < thickness - thicknessStep; t += thicknessStep) {
-        SDL_FPoint points[numCircleSegments + 1];
-        const float clampedRadius = SDL_max(radius - t, 1.0f);
+/* Destroys every text object that hasn't been drawn recently */
+static void SDL_Clay_SweepTextCache(Clay_SDL3RendererData *rendererData) {
+    rendererData->textCacheFrame++;
+    for (int slot = 0; slot < rendererData->textCacheCapacity; slot++) {
+        Clay_SDL3CachedText *cached = &rendererData->textCache[slot];
+        if (cached->id != 0 && rendererData->textCacheFrame - cached->lastUsedFrame > CLAY_SDL3_TEXT_CACHE_MAX_AGE) {
+            SDL_Clay_RemoveCachedText(rendererData, slot);
+            slot--; // Another entry may have been shifted back into this slot
+        }
+    }
+}
 
-        for (int i = 0; i <= numCircleSegments; i++) {
-            const float angle = radStart + i * angleStep;
-            points[i] = (SDL_FPoint){
-                    SDL_roundf(center.x + SDL_cosf(angle) * clampedRadius),
-                    SDL_roundf(center.y + SDL_sinf(angle) * clampedRadius) };
+/* Returns the text object for a text command, which is only shaped again if its string, font or size has changed.
+ * If the text can't be cached, *temporary is set to true and the caller must destroy it once it has been drawn. */
+static TTF_Text *SDL_Clay_GetText(Clay_SDL3RendererData *rendererData, Clay_RenderCommand *rcmd, bool *temporary) {
+    Clay_TextRenderData *config = &rcmd->renderData.text;
+    TTF_Font *font = SDL_Clay_GetSizedFont(rendererData, config->fontId, config->fontSize);
+    const uint64_t contentHash = SDL_Clay_TextContentHash(config);
+    const uint32_t id = rcmd->id ? rcmd->id : 1;
+    *temporary = false;
+
+    if (rendererData->textCacheCount >= rendererData->textCacheCapacity * 3 / 4 && !SDL_Clay_GrowTextCache(rendererData)) {
+        *temporary = true;
+        return TTF_CreateText(rendererData->textEngine, font, config->stringContents.chars, config->stringContents.length);
+    }
+    const int mask = rendererData->textCacheCapacity - 1;
+    int slot = (int)(id & mask);
+    while (rendererData->textCache[slot].id != 0 && rendererData->textCache[slot].id != id) {
+        slot = (slot + 1) & mask;
+    }
+    Clay_SDL3CachedText *cached = &rendererData->textCache[slot];
+    if (cached->id == id) {
+        if (cached->lastUsedFrame == rendererData->textCacheFrame) {
+            // Another command with the same id already used this text during the frame, and it may still be waiting to be drawn
+            *temporary = true;
+            return TTF_CreateText(rendererData->textEngine, font, config->stringContents.chars, config->stringContents.length);
+        }
+        if (cached->contentHash != contentHash) {
+            // Reuse the object for the element's new contents
+            TTF_SetTextFont(cached->text, font);
+            TTF_SetTextString(cached->text, config->stringContents.chars, config->stringContents.length);
+            cached->contentHash = contentHash;
         }
-        SDL_RenderLines(rendererData->renderer, points, numCircleSegments + 1);
+        cached->lastUsedFrame = rendererData->textCacheFrame;
+        return cached->text;
     }
+    TTF_Text *text = TTF_CreateText(rendererData->textEngine, font, config->stringContents.chars, config->stringContents.length);
+    if (text) {
+        *cached = (Clay_SDL3CachedText) { .id = id, .contentHash = contentHash, .text = text, .lastUsedFrame = rendererData->textCacheFrame };
+        rendererData->textCacheCount++;
+    }
+    return text;
+}
+
+/* Destroys every cached text object and font copy. Call this before destroying the text engine or the fonts. */
+static void SDL_Clay_DestroyTextCache(Clay_SDL3RendererData *rendererData) {
+    for (int slot = 0; slot < rendererData->textCacheCapacity; slot++) {
+        if (rendererData->textCache[slot].id != 0) {
+            TTF_DestroyText(rendererData->textCache[slot].text);
+        }
+    }
+    SDL_free(rendererData->textCache);
+    rendererData->textCache = NULL;
+    rendererData->textCacheCapacity = 0;
+    rendererData->textCacheCount = 0;
+    for (int i = 0; i < rendererData->sizedFontCount; i++) {
+        TTF_CloseFont(rendererData->sizedFonts[i].font);
+    }
+    SDL_free(rendererData->sizedFonts);
+    rendererData->sizedFonts = NULL;
+    rendererData->sizedFontCount = 0;
+}
+
+/* Releases everything the renderer allocated in rendererData. Call this before destroying the text engine or the fonts. */
+static void SDL_Clay_DestroyRendererData(Clay_SDL3RendererData *rendererData) {
+    SDL_Clay_DestroyTextCache(rendererData);
+    SDL_free(rendererData->batch.vertices);
+    SDL_free(rendererData->batch.indices);
+    rendererData->batch = (Clay_SDL3GeometryBatch) {0};
 }
 
 SDL_Rect currentClippingRectangle;
 
 static void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Clay_RenderCommandArray *rcommands)
 {
+    SDL_Clay_SweepTextCache(rendererData);
+    rendererData->drawCallCount = 0;
+    SDL_SetRenderDrawBlendMode(rendererData->renderer, SDL_BLENDMODE_BLEND);
     for (size_t i = 0; i < rcommands->length; i++) {
         Clay_RenderCommand *rcmd = Clay_RenderCommandArray_Get(rcommands, i);
         const Clay_BoundingBox bounding_box = rcmd->boundingBox;
@@ -153,22 +469,20 @@ static void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Cla
         switch (rcmd->commandType) {
             case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
                 Clay_RectangleRenderData *config = &rcmd->renderData.rectangle;
-                SDL_SetRenderDrawBlendMode(rendererData->renderer, SDL_BLENDMODE_BLEND);
-                SDL_SetRenderDrawColor(rendererData->renderer, config->backgroundColor.r, config->backgroundColor.g, config->backgroundColor.b, config->backgroundColor.a);
+                SDL_Clay_PrepareBatch(rendererData, rect);
                 if (config->cornerRadius.topLeft > 0) {
                     SDL_Clay_RenderFillRoundedRect(rendererData, rect, config->cornerRadius.topLeft, config->backgroundColor);
                 } else {
-                    SDL_RenderFillRect(rendererData->renderer, &rect);
+                    SDL_Clay_BatchFillRect(rendererData, rect, config->backgroundColor);
                 }
             } break;
             case CLAY_RENDER_COMMAND_TYPE_TEXT: {
                 Clay_TextRenderData *config = &rcmd->renderData.text;
-                TTF_Font *font = rendererData->fonts[config->fontId];
-                TTF_SetFontSize(font, config->fontSize);
-                TTF_Text *text = TTF_CreateText(rendererData->textEngine, font, config->stringContents.chars, config->stringContents.length);
+                bool temporary;
+                TTF_Text *text = SDL_Clay_GetText(rendererData, rcmd, &temporary);
+                if (!text) break;
                 TTF_SetTextColor(text, config->textColor.r, config->textColor.g, config->textColor.b, config->textColor.a);
-                TTF_DrawRendererText(text, rect.x, rect.y);
-                TTF_DestroyText(text);
+                SDL_Clay_DeferDraw(rendererData, (Clay_SDL3DeferredDraw) { .bounds = rect, .text = text, .temporary = temporary });
             } break;
             case CLAY_RENDER_COMMAND_TYPE_BORDER: {
                 Clay_BorderRenderData *config = &rcmd->renderData.border;
@@ -180,34 +494,33 @@ static void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Cla
                     .bottomLeft = SDL_min(config->cornerRadius.bottomLeft, minRadius),
                     .bottomRight = SDL_min(config->cornerRadius.bottomRight, minRadius)
                 };
+                SDL_Clay_PrepareBatch(rendererData, rect);
                 //edges
-                SDL_SetRenderDrawColor(rendererData->renderer, config->color.r, config->color.g, config->color.b, config->color.a);
                 if (config->width.left > 0) {
                     const float starting_y = rect.y + clampedRadii.topLeft;
                     const float length = rect.h - clampedRadii.topLeft - clampedRadii.bottomLeft;
                     SDL_FRect line = { rect.x - 1, starting_y, config->width.left, length };
-                    SDL_RenderFillRect(rendererData->renderer, &line);
+                    SDL_Clay_BatchFillRect(rendererData, line, config->color);
                 }
                 if (config->width.right > 0) {
                     const float starting_x = rect.x + rect.w - (float)config->width.right + 1;
                     const float starting_y = rect.y + clampedRadii.topRight;
                     const float length = rect.h - clampedRadii.topRight - clampedRadii.bottomRight;
                     SDL_FRect line = { starting_x, starting_y, config->width.right, length };
-                    SDL_RenderFillRect(rendererData->renderer, &line);
+                    SDL_Clay_BatchFillRect(rendererData, line, config->color);
                 }
                 if (config->width.top > 0) {
                     const float starting_x = rect.x + clampedRadii.topLeft;
                     const float length = rect.w - clampedRadii.topLeft - clampedRadii.topRight;
                     SDL_FRect line = { starting_x, rect.y - 1, length, config->width.top };
-                    SDL_RenderFillRect(rendererData->renderer, &line);
+                    SDL_Clay_BatchFillRect(rendererData, line, config->color);
                 }
                 if (config->width.bottom > 0) {
                     const float starting_x = rect.x + clampedRadii.bottomLeft;
                     const float starting_y = rect.y + rect.h - (float)config->width.bottom + 1;
                     const float length = rect.w - clampedRadii.bottomLeft - clampedRadii.bottomRight;
                     SDL_FRect line = { starting_x, starting_y, length, config->width.bottom };
-                    SDL_SetRenderDrawColor(rendererData->renderer, config->color.r, config->color.g, config->color.b, config->color.a);
-                    SDL_RenderFillRect(rendererData->renderer, &line);
+                    SDL_Clay_BatchFillRect(rendererData, line, config->color);
                 }
                 //corners
                 if (config->cornerRadius.topLeft > 0) {
@@ -237,6 +550,7 @@ static void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Cla
 
             } break;
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+                SDL_Clay_FlushBatch(rendererData);
                 Clay_BoundingBox boundingBox = rcmd->boundingBox;
                 currentClippingRectangle = (SDL_Rect) {
                         .x = boundingBox.x,
@@ -248,17 +562,18 @@ static void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Cla
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+                SDL_Clay_FlushBatch(rendererData);
                 SDL_SetRenderClipRect(rendererData->renderer, NULL);
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
                 SDL_Texture *texture = (SDL_Texture *)rcmd->renderData.image.imageData;
-                const SDL_FRect dest = { rect.x, rect.y, rect.w, rect.h };
-                SDL_RenderTexture(rendererData->renderer, texture, NULL, &dest);
+                SDL_Clay_DeferDraw(rendererData, (Clay_SDL3DeferredDraw) { .bounds = rect, .texture = texture });
                 break;
             }
             default:
                 SDL_Log("Unknown render command type: %d", rcmd->commandType);
         }
     }
+    SDL_Clay_FlushBatch(rendererData);
 }
@@ -4,6 +4,7 @@
 #include "string.h"
 #include "stdio.h"
 #include "stdlib.h"
+#include "stddef.h"
 
 #define CLAY_RECTANGLE_TO_RAYLIB_RECTANGLE(rectangle) (Rectangle) { .x = rectangle.x, .y = rectangle.y, .width = rectangle.width, .height = rectangle.height }
 #define CLAY_COLOR_TO_RAYLIB_COLOR(color) (Color) { .r = (unsigned char)roundf(color.r), .g = (unsigned char)roundf(color.g), .b = (unsigned char)roundf(color.b), .a = (unsigned char)roundf(color.a) }
@@ -81,6 +82,78 @@ Ray GetScreenToWorldPointWithZDistance(Vector2 position, Camera camera, int scre
 }
 
 
+// The glyph index and advance of recently used codepoints, for each font id below CLAY_RAYLIB_MAX_GLYPH_TABLES
+#ifndef CLAY_RAYLIB_MAX_GLYPH_TABLES
+#define CLAY_RAYLIB_MAX_GLYPH_TABLES 16
+#endif
+// Must be a power of two. Codepoints are direct mapped, so ASCII and any other range of this size never collide.
+#ifndef CLAY_RAYLIB_GLYPH_TABLE_SIZE
+#define CLAY_RAYLIB_GLYPH_TABLE_SIZE 256
+#endif
+
+typedef struct
+{
+    int codepoint;
+    int glyphIndex;
+    float advance; // Unscaled, in units of the font's base size
+} Raylib_GlyphTableEntry;
+
+typedef struct
+{
+    GlyphInfo *glyphs; // The font the table was filled from, so that replaced fonts are detected
+    Raylib_GlyphTableEntry entries[CLAY_RAYLIB_GLYPH_TABLE_SIZE];
+} Raylib_GlyphTable;
+
+static Raylib_GlyphTable Raylib_glyphTables[CLAY_RAYLIB_MAX_GLYPH_TABLES];
+
+// Font failed to load, likely the fonts are in the wrong place relative to the execution dir.
+// RayLib ships with a default font, so we can continue with that built in one.
+static inline Font Raylib_GetFont(Font *fonts, uint16_t fontId) {
+    Font font = fonts[fontId];
+    return font.glyphs && font.texture.id != 0 ? font : GetFontDefault();
+}
+
+static inline Raylib_GlyphTable *Raylib_GetGlyphTable(Font font, uint16_t fontId) {
+    if (fontId >= CLAY_RAYLIB_MAX_GLYPH_TABLES) return NULL;
+    Raylib_GlyphTable *table = &Raylib_glyphTables[fontId];
+    if (table->glyphs != font.glyphs) {
+        table->glyphs = font.glyphs;
+        for (int i = 0; i < CLAY_RAYLIB_GLYPH_TABLE_SIZE; i++) {
+            table->entries[i].codepoint = -1;
+        }
+    }
+    return table;
+}
+
+// Same glyph lookup and advance as DrawTextEx, but GetGlyphIndex's search of the font only runs when a codepoint isn't in the table
+static inline Raylib_GlyphTableEntry Raylib_GetGlyph(Raylib_GlyphTable *table, Font font, int codepoint) {
+    Raylib_GlyphTableEntry *entry = table ? &table->entries[codepoint & (CLAY_RAYLIB_GLYPH_TABLE_SIZE - 1)] : NULL;
+    if (entry && entry->codepoint == codepoint) return *entry;
+    int index = GetGlyphIndex(font, codepoint);
+    Raylib_GlyphTableEntry glyph = { codepoint, index, font.glyphs[index].advanceX != 0 ? (float)font.glyphs[index].advanceX : font.recs[index].width };
+    if (entry) *entry = glyph;
+    return glyph;
+}
+
+// Decodes the UTF-8 codepoint at the start of chars without reading past length. Like GetCodepointNext, invalid sequences decode to '?'.
+static inline int Raylib_DecodeCodepoint(const char *chars, int32_t length, int32_t *byteCount) {
+    const unsigned char *bytes = (const unsigned char *)chars;
+    int codepoint;
+    int32_t count;
+    if (bytes[0] < 0x80) { *byteCount = 1; return bytes[0]; }
+    else if ((bytes[0] & 0xe0) == 0xc0) { codepoint = bytes[0] & 0x1f; count = 2; }
+    else if ((bytes[0] & 0xf0) == 0xe0) { codepoint = bytes[0] & 0x0f; count = 3; }
+    else if ((bytes[0] & 0xf8) == 0xf0) { codepoint = bytes[0] & 0x07; count = 4; }
+    else { *byteCount = 1; return '?'; }
+    if (count > length) { *byteCount = 1; return '?'; }
+    for (int32_t i = 1; i < count; i++) {
+        if ((bytes[i] & 0xc0) != 0x80) { *byteCount = 1; return '?'; }
+        codepoint = (codepoint << 6) | (bytes[i] & 0x3f);
+    }
+    *byteCount = count;
+    return codepoint;
+}
+
 static inline Clay_Dimensions Raylib_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
     // Measure string size for Font
     Clay_Dimensions textSize = { 0 };
@@ -91,114 +164,372 @@ static inline Clay_Dimensions Raylib_MeasureText(Clay_StringSlice text, Clay_Tex
     int lineCharCount = 0;
 
     float textHeight = config->fontSize;
-    Font* fonts = (Font*)userData;
-    Font fontToUse = fonts[config->fontId];
-    // Font failed to load, likely the fonts are in the wrong place relative to the execution dir.
-    // RayLib ships with a default font, so we can continue with that built in one. 
-    if (!fontToUse.glyphs) {
-        fontToUse = GetFontDefault();
-    }
+    Font fontToUse = Raylib_GetFont((Font*)userData, config->fontId);
+    Raylib_GlyphTable *glyphTable = Raylib_GetGlyphTable(fontToUse, config->fontId);
 
     float scaleFactor = config->fontSize/(float)fontToUse.baseSize;
 
-    for (int i = 0; i < text.length; ++i, lineCharCount++)
+    for (int32_t i = 0, byteCount; i < text.length; i += byteCount)
     {
-        if (text.chars[i] == '\n') {
+        int codepoint = Raylib_DecodeCodepoint(text.chars + i, text.length - i, &byteCount);
+        if (codepoint == '\n') {
             maxTextWidth = fmax(maxTextWidth, lineTextWidth);
             maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
             lineTextWidth = 0;
             lineCharCount = 0;
             continue;
         }
-        int index = text.chars[i] - 32;
-        if (fontToUse.glyphs[index].advanceX != 0) lineTextWidth += fontToUse.glyphs[index].advanceX;
-        else lineTextWidth += (fontToUse.recs[index].width + fontToUse.glyphs[index].offsetX);
+        lineTextWidth += Raylib_GetGlyph(glyphTable, fontToUse, codepoint).advance;
+        lineCharCount++;
     }
 
     maxTextWidth = fmax(maxTextWidth, lineTextWidth);
     maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
 
-    textSize.width = maxTextWidth * scaleFactor + (lineCharCount * config->letterSpacing);
+    textSize.width = maxTextWidth * scaleFactor + (maxLineCharCount * config->letterSpacing);
     textSize.height = textHeight;
 
     return textSize;
 }
 
+// Draws text straight from the slice, glyph by glyph, the same way as DrawTextEx does with a null terminated copy
+static void Raylib_DrawTextSlice(Font font, Raylib_GlyphTable *glyphTable, Clay_StringSlice text, Vector2 position, float fontSize, float spacing, Color tint) {
+    float scaleFactor = fontSize/(float)font.baseSize;
+    float padding = (float)font.glyphPadding;
+    Vector2 offset = { 0, 0 };
+
+    for (int32_t i = 0, byteCount; i < text.length; i += byteCount)
+    {
+        int codepoint = Raylib_DecodeCodepoint(text.chars + i, text.length - i, &byteCount);
+        if (codepoint == '\n') {
+            offset.y += fontSize + 2; // DrawTextEx's default line spacing
+            offset.x = 0;
+            continue;
+        }
+        Raylib_GlyphTableEntry glyph = Raylib_GetGlyph(glyphTable, font, codepoint);
+        if (codepoint != ' ' && codepoint != '\t') {
+            GlyphInfo *info = &font.glyphs[glyph.glyphIndex];
+            Rectangle rec = font.recs[glyph.glyphIndex];
+            Rectangle source = { rec.x - padding, rec.y - padding, rec.width + 2.0f*padding, rec.height + 2.0f*padding };
+            Rectangle dest = {
+                position.x + offset.x + (info->offsetX - padding)*scaleFactor,
+                position.y + offset.y + (info->offsetY - padding)*scaleFactor,
+                source.width*scaleFactor,
+                source.height*scaleFactor
+            };
+            DrawTexturePro(font.texture, source, dest, (Vector2){ 0, 0 }, 0.0f, tint);
+        }
+        offset.x += glyph.advance*scaleFactor + spacing;
+    }
+}
+
+static inline Clay_BoundingBox Raylib_RoundBoundingBox(Clay_BoundingBox box) {
+    return (Clay_BoundingBox) { roundf(box.x), roundf(box.y), roundf(box.width), roundf(box.height) };
+}
+
+static void Raylib_DrawTextCommand(Clay_RenderCommand *renderCommand, Font *fonts) {
+    Clay_TextRenderData *textData = &renderCommand->renderData.text;
+    Clay_BoundingBox boundingBox = Raylib_RoundBoundingBox(renderCommand->boundingBox);
+    Font fontToUse = Raylib_GetFont(fonts, textData->fontId);
+    Raylib_DrawTextSlice(fontToUse, Raylib_GetGlyphTable(fontToUse, textData->fontId), textData->stringContents, (Vector2){boundingBox.x, boundingBox.y}, (float)textData->fontSize, (float)textData->letterSpacing, CLAY_COLOR_TO_RAYLIB_COLOR(textData->textColor));
+}
+
+static void Raylib_DrawImageCommand(Clay_RenderCommand *renderCommand) {
+    Clay_BoundingBox boundingBox = Raylib_RoundBoundingBox(renderCommand->boundingBox);
+    Texture2D imageTexture = *(Texture2D *)renderCommand->renderData.image.imageData;
+    Clay_Color tintColor = renderCommand->renderData.image.backgroundColor;
+    if (tintColor.r == 0 && tintColor.g == 0 && tintColor.b == 0 && tintColor.a == 0) {
+        tintColor = (Clay_Color) { 255, 255, 255, 255 };
+    }
+    DrawTexturePro(
+        imageTexture,
+        (Rectangle) { 0, 0, imageTexture.width, imageTexture.height },
+        (Rectangle){boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height},
+        (Vector2) {},
+        0,
+        CLAY_COLOR_TO_RAYLIB_COLOR(tintColor));
+}
+
+#ifndef CLAY_RAYLIB_NO_BATCH
+#include "rlgl.h"
+
+// Rectangles, rounded rectangles and borders are written into one vertex buffer as quads, and their corners and border cut outs
+// are computed from a signed distance function in the fragment shader. At most 16384, as rlgl draws with 16 bit indices.
+#ifndef CLAY_RAYLIB_BATCH_MAX_QUADS
+#define CLAY_RAYLIB_BATCH_MAX_QUADS 4096
+#endif
+// Text and images wait for the batch for at most this many draws before it is flushed
+#ifndef CLAY_RAYLIB_MAX_DEFERRED_DRAWS
+#define CLAY_RAYLIB_MAX_DEFERRED_DRAWS 256
+#endif
+
+typedef struct
+{
+    float x, y;
+    float localX, localY; // Relative to the center of the quad
+    float halfWidth, halfHeight;
+    float radii[4]; // Top left, top right, bottom right, bottom left
+    float borders[4]; // Left, top, right, bottom. All zero for a filled shape.
+    unsigned char color[4];
+} Raylib_BatchVertex;
+
+typedef struct
+{
+    bool initialized;
+    bool available; // False if the shader or vertex array couldn't be created, then shapes are drawn one at a time instead
+    bool disabled;
+    unsigned int shader, vao, vbo, ebo;
+    int mvpLocation;
+    int quadCount;
+    Raylib_BatchVertex vertices[CLAY_RAYLIB_BATCH_MAX_QUADS * 4];
+    // Text and image commands are drawn after the shapes in the batch, which is only valid while no later shape overlaps them
+    Clay_RenderCommand *deferred[CLAY_RAYLIB_MAX_DEFERRED_DRAWS];
+    int deferredCount;
+} Raylib_Batch;
+
+static Raylib_Batch Raylib_batch;
+
+#define CLAY_RAYLIB_BATCH_VERTEX_SHADER \
+    "IN_ATTRIBUTE vec2 vertexPosition;\n" \
+    "IN_ATTRIBUTE vec2 vertexLocal;\n" \
+    "IN_ATTRIBUTE vec2 vertexHalfSize;\n" \
+    "IN_ATTRIBUTE vec4 vertexRadii;\n" \
+    "IN_ATTRIBUTE vec4 vertexBorders;\n" \
+    "IN_ATTRIBUTE vec4 vertexColor;\n" \
+    "VARYING vec2 fragLocal;\n" \
+    "VARYING vec2 fragHalfSize;\n" \
+    "VARYING vec4 fragRadii;\n" \
+    "VARYING vec4 fragBorders;\n" \
+    "VARYING vec4 fragColor;\n" \
+    "uniform mat4 mvp;\n" \
+    "void main() {\n" \
+    "    fragLocal = vertexLocal;\n" \
+    "    fragHalfSize = vertexHalfSize;\n" \
+    "    fragRadii = vertexRadii;\n" \
+    "    fragBorders = vertexBorders;\n" \
+    "    fragColor = vertexColor;\n" \
+    "    gl_Position = mvp*vec4(vertexPosition, 0.0, 1.0);\n" \
+    "}\n"
+
+#define CLAY_RAYLIB_BATCH_FRAGMENT_SHADER \
+    "VARYING vec2 fragLocal;\n" \
+    "VARYING vec2 fragHalfSize;\n" \
+    "VARYING vec4 fragRadii;\n" \
+    "VARYING vec4 fragBorders;\n" \
+    "VARYING vec4 fragColor;\n" \
+    "float roundedBoxDistance(vec2 p, vec2 halfSize, vec4 radii) {\n" \
+    "    float r = p.x < 0.0 ? (p.y < 0.0 ? radii.x : radii.w) : (p.y < 0.0 ? radii.y : radii.z);\n" \
+    "    vec2 q = abs(p) - halfSize + r;\n" \
+    "    return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r;\n" \
+    "}\n" \
+    "void main() {\n" \
+    "    float alpha = clamp(0.5 - roundedBoxDistance(fragLocal, fragHalfSize, fragRadii), 0.0, 1.0);\n" \
+    "    vec4 b = fragBorders;\n" \
+    "    if (b.x + b.y + b.z + b.w > 0.0) {\n" \
+    "        vec2 innerCenter = 0.5*vec2(b.x - b.z, b.y - b.w);\n" \
+    "        vec2 innerHalfSize = fragHalfSize - 0.5*vec2(b.x + b.z, b.y + b.w);\n" \
+    "        vec4 innerRadii = max(fragRadii - vec4(max(b.x, b.y), max(b.z, b.y), max(b.z, b.w), max(b.x, b.w)), 0.0);\n" \
+    "        alpha *= clamp(0.5 + roundedBoxDistance(fragLocal - innerCenter, innerHalfSize, innerRadii), 0.0, 1.0);\n" \
+    "    }\n" \
+    "    FRAG_COLOR = vec4(fragColor.rgb, fragColor.a*alpha);\n" \
+    "}\n"
+
+static void Raylib_SetBatchAttribute(const char *name, int size, int type, bool normalized, int offset) {
+    int location = rlGetLocationAttrib(Raylib_batch.shader, name);
+    if (location < 0) return;
+    rlSetVertexAttribute((unsigned int)location, size, type, normalized, sizeof(Raylib_BatchVertex), offset);
+    rlEnableVertexAttribute((unsigned int)location);
+}
+
+static void Raylib_InitializeBatch(void) {
+    Raylib_batch.initialized = true;
+    int version = rlGetVersion();
+    if (version == RL_OPENGL_ES_20 || version == RL_OPENGL_ES_30) {
+        Raylib_batch.shader = rlLoadShaderCode(
+            "#version 100\n#define IN_ATTRIBUTE attribute\n#define VARYING varying\n" CLAY_RAYLIB_BATCH_VERTEX_SHADER,
+            "#version 100\n#ifdef GL_FRAGMENT_PRECISION_HIGH\nprecision highp float;\n#else\nprecision mediump float;\n#endif\n#define VARYING varying\n#define FRAG_COLOR gl_FragColor\n" CLAY_RAYLIB_BATCH_FRAGMENT_SHADER);
+    } else if (version == RL_OPENGL_21) {
+        Raylib_batch.shader = rlLoadShaderCode(
+            "#version 120\n#define IN_ATTRIBUTE attribute\n#define VARYING varying\n" CLAY_RAYLIB_BATCH_VERTEX_SHADER,
+            "#version 120\n#define VARYING varying\n#define FRAG_COLOR gl_FragColor\n" CLAY_RAYLIB_BATCH_FRAGMENT_SHADER);
+    } else if (version == RL_OPENGL_33 || version == RL_OPENGL_43) {
+        Raylib_batch.shader = rlLoadShaderCode(
+            "#version 330\n#define IN_ATTRIBUTE in\n#define VARYING out\n" CLAY_RAYLIB_BATCH_VERTEX_SHADER,
+            "#version 330\n#define VARYING in\nout vec4 finalColor;\n#define FRAG_COLOR finalColor\n" CLAY_RAYLIB_BATCH_FRAGMENT_SHADER);
+    }
+    if (Raylib_batch.shader == 0 || Raylib_batch.shader == rlGetShaderIdDefault()) return;
+    Raylib_batch.vao = rlLoadVertexArray();
+    if (Raylib_batch.vao == 0) {
+        rlUnloadShaderProgram(Raylib_batch.shader);
+        Raylib_batch.shader = 0;
+        return;
+    }
+    unsigned short *indices = (unsigned short *)malloc(CLAY_RAYLIB_BATCH_MAX_QUADS * 6 * sizeof(unsigned short));
+    for (int i = 0; i < CLAY_RAYLIB_BATCH_MAX_QUADS; i++) {
+        unsigned short *quad = &indices[i * 6];
+        quad[0] = i * 4; quad[1] = i * 4 + 1; quad[2] = i * 4 + 3;
+        quad[3] = i * 4 + 1; quad[4] = i * 4 + 2; quad[5] = i * 4 + 3;
+    }
+    rlEnableVertexArray(Raylib_batch.vao);
+    Raylib_batch.vbo = rlLoadVertexBuffer(NULL, sizeof(Raylib_batch.vertices), true);
+    Raylib_SetBatchAttribute("vertexPosition", 2, RL_FLOAT, false, offsetof(Raylib_BatchVertex, x));
+    Raylib_SetBatchAttribute("vertexLocal", 2, RL_FLOAT, false, offsetof(Raylib_BatchVertex, localX));
+    Raylib_SetBatchAttribute("vertexHalfSize", 2, RL_FLOAT, false, offsetof(Raylib_BatchVertex, halfWidth));
+    Raylib_SetBatchAttribute("vertexRadii", 4, RL_FLOAT, false, offsetof(Raylib_BatchVertex, radii));
+    Raylib_SetBatchAttribute("vertexBorders", 4, RL_FLOAT, false, offsetof(Raylib_BatchVertex, borders));
+    Raylib_SetBatchAttribute("vertexColor", 4, RL_UNSIGNED_BYTE, true, offsetof(Raylib_BatchVertex, color));
+    Raylib_batch.ebo = rlLoadVertexBufferElement(indices, CLAY_RAYLIB_BATCH_MAX_QUADS * 6 * sizeof(unsigned short), false);
+    rlDisableVertexArray();
+    free(indices);
+    Raylib_batch.mvpLocation = rlGetLocationUniform(Raylib_batch.shader, "mvp");
+    Raylib_batch.available = true;
+}
+
+static void Raylib_UnloadBatch(void) {
+    if (Raylib_batch.available) {
+        rlUnloadVertexArray(Raylib_batch.vao);
+        rlUnloadVertexBuffer(Raylib_batch.vbo);
+        rlUnloadVertexBuffer(Raylib_batch.ebo);
+        rlUnloadShaderProgram(Raylib_batch.shader);
+    }
+    Raylib_batch.initialized = false;
+    Raylib_batch.available = false;
+    Raylib_batch.shader = 0;
+}
+
+static bool Raylib_BatchActive(void) {
+    if (!Raylib_batch.initialized) Raylib_InitializeBatch();
+    return Raylib_batch.available && !Raylib_batch.disabled;
+}
+
+// Draws the batched shapes with a single draw call, then the text and images that were deferred behind them.
+// Called at scissor boundaries, before custom elements, and when a shape would otherwise be drawn over a deferred draw that comes before it.
+static void Raylib_FlushBatch(Font *fonts) {
+    if (Raylib_batch.quadCount > 0) {
+        rlDrawRenderBatchActive(); // Anything raylib has batched up to now is underneath the shapes
+        rlUpdateVertexBuffer(Raylib_batch.vbo, Raylib_batch.vertices, Raylib_batch.quadCount * 4 * sizeof(Raylib_BatchVertex), 0);
+        rlEnableShader(Raylib_batch.shader);
+        rlSetUniformMatrix(Raylib_batch.mvpLocation, MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+        rlEnableVertexArray(Raylib_batch.vao);
+        rlDrawVertexArrayElements(0, Raylib_batch.quadCount * 6, 0);
+        rlDisableVertexArray();
+        rlDisableShader();
+        Raylib_batch.quadCount = 0;
+    }
+    for (int i = 0; i < Raylib_batch.deferredCount; i++) {
+        Clay_RenderCommand *renderCommand = Raylib_batch.deferred[i];
+        if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT) {
+            Raylib_DrawTextCommand(renderCommand, fonts);
+        } else {
+            Raylib_DrawImageCommand(renderCommand);
+        }
+    }
+    Raylib_batch.deferredCount = 0;
+}
+
+static void Raylib_DeferDraw(Clay_RenderCommand *renderCommand, Font *fonts) {
+    if (Raylib_batch.deferredCount == CLAY_RAYLIB_MAX_DEFERRED_DRAWS) {
+        Raylib_FlushBatch(fonts);
+    }
+    Raylib_batch.deferred[Raylib_batch.deferredCount++] = renderCommand;
+}
+
+// Adds a filled or bordered rounded rectangle to the batch, first flushing it if the shape would cover a deferred draw
+static void Raylib_BatchShape(Clay_BoundingBox box, Clay_CornerRadius cornerRadius, Clay_BorderWidth border, Clay_Color color, Font *fonts) {
+    if (box.width <= 0 || box.height <= 0) return;
+    for (int i = 0; i < Raylib_batch.deferredCount; i++) {
+        // With a pixel of margin, as glyphs can reach slightly outside of their text's bounding box
+        Clay_BoundingBox other = Raylib_batch.deferred[i]->boundingBox;
+        if (box.x < other.x + other.width + 1 && other.x - 1 < box.x + box.width && box.y < other.y + other.height + 1 && other.y - 1 < box.y + box.height) {
+            Raylib_FlushBatch(fonts);
+            break;
+        }
+    }
+    if (Raylib_batch.quadCount == CLAY_RAYLIB_BATCH_MAX_QUADS) {
+        Raylib_FlushBatch(fonts);
+    }
+    float halfWidth = box.width / 2, halfHeight = box.height / 2;
+    float maxRadius = CLAY__MIN(halfWidth, halfHeight);
+    Raylib_BatchVertex vertex = {
+        .halfWidth = halfWidth,
+        .halfHeight = halfHeight,
+        .radii = { CLAY__MIN(cornerRadius.topLeft, maxRadius), CLAY__MIN(cornerRadius.topRight, maxRadius), CLAY__MIN(cornerRadius.bottomRight, maxRadius), CLAY__MIN(cornerRadius.bottomLeft, maxRadius) },
+        .borders = { border.left, border.top, border.right, border.bottom },
+        .color = { (unsigned char)roundf(color.r), (unsigned char)roundf(color.g), (unsigned char)roundf(color.b), (unsigned char)roundf(color.a) },
+    };
+    Raylib_BatchVertex *quad = &Raylib_batch.vertices[Raylib_batch.quadCount++ * 4];
+    for (int i = 0; i < 4; i++) {
+        float signX = (i == 1 || i == 2) ? 1 : -1;
+        float signY = i >= 2 ? 1 : -1;
+        quad[i] = vertex;
+        quad[i].localX = signX * halfWidth;
+        quad[i].localY = signY * halfHeight;
+        quad[i].x = box.x + halfWidth + quad[i].localX;
+        quad[i].y = box.y + halfHeight + quad[i].localY;
+    }
+}
+
+// Batching is on by default, and can be turned off to compare against drawing each shape with raylib's shape functions
+void Clay_Raylib_SetBatchingEnabled(bool enabled) {
+    Raylib_batch.disabled = !enabled;
+}
+#else
+static inline bool Raylib_BatchActive(void) { return false; }
+static inline void Raylib_UnloadBatch(void) {}
+static inline void Raylib_FlushBatch(Font *fonts) {}
+static inline void Raylib_DeferDraw(Clay_RenderCommand *renderCommand, Font *fonts) {}
+static inline void Raylib_BatchShape(Clay_BoundingBox box, Clay_CornerRadius cornerRadius, Clay_BorderWidth border, Clay_Color color, Font *fonts) {}
+void Clay_Raylib_SetBatchingEnabled(bool enabled) {}
+#endif
+
 void Clay_Raylib_Initialize(int width, int height, const char *title, unsigned int flags) {
     SetConfigFlags(flags);
     InitWindow(width, height, title);
 //    EnableEventWaiting();
 }
 
-// A MALLOC'd buffer, that we keep modifying inorder to save from so many Malloc and Free Calls.
-// Call Clay_Raylib_Close() to free
-static char *temp_render_buffer = NULL;
-static int temp_render_buffer_len = 0;
-
-// Call after closing the window to clean up the render buffer
+// Call to release the renderer's resources and close the window
 void Clay_Raylib_Close()
 {
-    if(temp_render_buffer) free(temp_render_buffer);
-    temp_render_buffer_len = 0;
-
+    Raylib_UnloadBatch();
     CloseWindow();
 }
 
 
 void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
 {
+    bool batching = Raylib_BatchActive();
     for (int j = 0; j < renderCommands.length; j++)
     {
         Clay_RenderCommand *renderCommand = Clay_RenderCommandArray_Get(&renderCommands, j);
-        Clay_BoundingBox boundingBox = {roundf(renderCommand->boundingBox.x), roundf(renderCommand->boundingBox.y), roundf(renderCommand->boundingBox.width), roundf(renderCommand->boundingBox.height)};
+        Clay_BoundingBox boundingBox = Raylib_RoundBoundingBox(renderCommand->boundingBox);
         switch (renderCommand->commandType)
         {
             case CLAY_RENDER_COMMAND_TYPE_TEXT: {
-                Clay_TextRenderData *textData = &renderCommand->renderData.text;
-                Font fontToUse = fonts[textData->fontId];
-    
-                int strlen = textData->stringContents.length + 1;
-    
-                if(strlen > temp_render_buffer_len) {
-                    // Grow the temp buffer if we need a larger string
-                    if(temp_render_buffer) free(temp_render_buffer);
-                    temp_render_buffer = (char *) malloc(strlen);
-                    temp_render_buffer_len = strlen;
-                }
-    
-                // Raylib uses standard C strings so isn't compatible with cheap slices, we need to clone the string to append null terminator
-                memcpy(temp_render_buffer, textData->stringContents.chars, textData->stringContents.length);
-                temp_render_buffer[textData->stringContents.length] = '\0';
-                DrawTextEx(fontToUse, temp_render_buffer, (Vector2){boundingBox.x, boundingBox.y}, (float)textData->fontSize, (float)textData->letterSpacing, CLAY_COLOR_TO_RAYLIB_COLOR(textData->textColor));
-    
+                if (batching) Raylib_DeferDraw(renderCommand, fonts);
+                else Raylib_DrawTextCommand(renderCommand, fonts);
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
-                Texture2D imageTexture = *(Texture2D *)renderCommand->renderData.image.imageData;
-                Clay_Color tintColor = renderCommand->renderData.image.backgroundColor;
-                if (tintColor.r == 0 && tintColor.g == 0 && tintColor.b == 0 && tintColor.a == 0) {
-                    tintColor = (Clay_Color) { 255, 255, 255, 255 };
-                }
-                DrawTexturePro(
-                    imageTexture,
-                    (Rectangle) { 0, 0, imageTexture.width, imageTexture.height },
-                    (Rectangle){boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height},
-                    (Vector2) {},
-                    0,
-                    CLAY_COLOR_TO_RAYLIB_COLOR(tintColor));
+                if (batching) Raylib_DeferDraw(renderCommand, fonts);
+                else Raylib_DrawImageCommand(renderCommand);
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+                Raylib_FlushBatch(fonts);
                 BeginScissorMode((int)roundf(boundingBox.x), (int)roundf(boundingBox.y), (int)roundf(boundingBox.width), (int)roundf(boundingBox.height));
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+                Raylib_FlushBatch(fonts);
                 EndScissorMode();
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
                 Clay_RectangleRenderData *config = &renderCommand->renderData.rectangle;
-                if (config->cornerRadius.topLeft > 0) {
+                if (batching) {
+                    Raylib_BatchShape(boundingBox, config->cornerRadius, (Clay_BorderWidth) {0}, config->backgroundColor, fonts);
+                } else if (config->cornerRadius.topLeft > 0) {
                     float radius = (config->cornerRadius.topLeft * 2) / (float)((boundingBox.width > boundingBox.height) ? boundingBox.height : boundingBox.width);
                     DrawRectangleRounded((Rectangle) { boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height }, radius, 8, CLAY_COLOR_TO_RAYLIB_COLOR(config->backgroundColor));
                 } else {
@@ -208,6 +539,10 @@ void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
             }
             case CLAY_RENDER_COMMAND_TYPE_BORDER: {
                 Clay_BorderRenderData *config = &renderCommand->renderData.border;
+                if (batching) {
+                    Raylib_BatchShape(boundingBox, config->cornerRadius, config->width, config->color, fonts);
+                    break;
+                }
                 // Left border
                 if (config->width.left > 0) {
                     DrawRectangle((int)roundf(boundingBox.x), (int)roundf(boundingBox.y + config->cornerRadius.topLeft), (int)config->width.left, (int)roundf(boundingBox.height - config->cornerRadius.topLeft - config->cornerRadius.bottomLeft), CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
@@ -240,6 +575,7 @@ void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
             }
             case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
                 Clay_CustomRenderData *config = &renderCommand->renderData.custom;
+                Raylib_FlushBatch(fonts);
                 
                 // Check if this is a pie chart element (using the magic number)
                 if (config->customData) {
@@ -287,4 +623,5 @@ void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
             }
         }
     }
+    Raylib_FlushBatch(fonts);
 }
@@ -0,0 +1,65 @@
+// Checks that changing or moving one element damages only the areas it covered and now covers, and that damage tracking can't be
+// enabled without its memory.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include "test.h"
+
+// A fixed size column of rows, with a floating marker outside of it that can be moved without affecting anything else
+Clay_RenderCommandArray RunFrame(Clay_Color highlight, float markerY) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Root"), { .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = { CLAY_SIZING_FIXED(200), CLAY_SIZING_FIXED(400) }, .childGap = 4 }, .backgroundColor = { 20, 20, 20, 255 } }) {
+        for (int32_t i = 0; i < 5; ++i) {
+            CLAY(CLAY_IDI("Row", i), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(20) } }, .backgroundColor = i == 2 ? highlight : (Clay_Color) { 40, 40, 40, 255 } }) {}
+        }
+        CLAY(CLAY_ID("Marker"), { .floating = { .attachTo = CLAY_ATTACH_TO_PARENT, .offset = { 220, markerY } }, .layout = { .sizing = { CLAY_SIZING_FIXED(40), CLAY_SIZING_FIXED(40) } }, .backgroundColor = { 0, 0, 255, 255 } }) {}
+    }
+    return Clay_EndLayout();
+}
+
+int main(void) {
+    Clay_Color gray = { 40, 40, 40, 255 };
+    Clay_Color yellow = { 255, 255, 0, 255 };
+
+    // Without a .diffedRenderCommands, enabling damage tracking reports one error and leaves it disabled, rather than failing every frame
+    Clay_Arena withoutMemoryArena = Test_CreateContext((Clay_Dimensions) { 300, 600 });
+    Clay_SetDamageTrackingEnabled(true);
+    TEST_CHECK(Test_errorCount == 1);
+    RunFrame(gray, 10);
+    RunFrame(yellow, 10);
+    TEST_CHECK(Test_errorCount == 1);
+    TEST_CHECK(Clay_GetDamageRectangles().length == 0);
+    free(withoutMemoryArena.memory);
+    Clay_SetCurrentContext(NULL);
+    Test_errorCount = 0;
+
+    Clay_SetArrayCapacities((Clay_ArrayCapacities) { .diffedRenderCommands = 64 });
+    Clay_Arena arena = Test_CreateContext((Clay_Dimensions) { 300, 600 });
+    Clay_SetDamageTrackingEnabled(true);
+
+    // The first frame damages the entire layout, and an identical frame damages nothing
+    RunFrame(gray, 10);
+    Clay_BoundingBoxArray damage = Clay_GetDamageRectangles();
+    TEST_CHECK(damage.length == 1 && Test_BoundingBoxesEqual(damage.internalArray[0], (Clay_BoundingBox) { 0, 0, 300, 600 }));
+    RunFrame(gray, 10);
+    TEST_CHECK(Clay_GetDamageRectangles().length == 0);
+
+    // Changing the color of one row damages exactly that row
+    RunFrame(yellow, 10);
+    damage = Clay_GetDamageRectangles();
+    TEST_CHECK(damage.length == 1 && Test_BoundingBoxesEqual(damage.internalArray[0], (Clay_BoundingBox) { 0, 48, 200, 20 }));
+
+    // Moving the marker damages where it was and where it is now, which are far enough apart to stay separate
+    RunFrame(yellow, 500);
+    damage = Clay_GetDamageRectangles();
+    TEST_CHECK(damage.length == 2);
+    if (damage.length == 2) {
+        Clay_BoundingBox previous = { 220, 10, 40, 40 };
+        Clay_BoundingBox current = { 220, 500, 40, 40 };
+        TEST_CHECK((Test_BoundingBoxesEqual(damage.internalArray[0], previous) && Test_BoundingBoxesEqual(damage.internalArray[1], current))
+            || (Test_BoundingBoxesEqual(damage.internalArray[0], current) && Test_BoundingBoxesEqual(damage.internalArray[1], previous)));
+    }
+
+    TEST_CHECK(Test_errorCount == 0);
+    free(arena.memory);
+    return Test_Finish("damage_rectangles");
+}
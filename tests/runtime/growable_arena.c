@@ -0,0 +1,105 @@
+// Checks that a growable arena grows to fit layouts with more elements than it started with, without errors, and that
+// Clay_ReleaseGrowable releases everything that was reserved.
+#ifndef _WIN32
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS
+#endif
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include "test.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#endif
+
+typedef struct {
+    size_t reservedBytes;
+    size_t releasedBytes;
+} ArenaMemory;
+
+void *ReserveMemory(size_t size, void *userData) {
+    ((ArenaMemory *)userData)->reservedBytes += size;
+#ifdef _WIN32
+    return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void *memory = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return memory == MAP_FAILED ? NULL : memory;
+#endif
+}
+
+bool CommitMemory(void *memory, size_t size, void *userData) {
+    (void)userData;
+#ifdef _WIN32
+    return VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+    return mprotect(memory, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void ReleaseMemory(void *memory, size_t size, void *userData) {
+    ((ArenaMemory *)userData)->releasedBytes += size;
+#ifdef _WIN32
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, size);
+#endif
+}
+
+// A list of rows, every fourth of which contains text, so that the element and text arrays both need to grow, followed by a row
+// that can be found by its ID. Returns the number of layout elements that were declared.
+int32_t RunFrame(int32_t rowCount) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Root"), { .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) } } }) {
+        for (int32_t i = 0; i < rowCount; ++i) {
+            CLAY_AUTO_ID({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(10) } }, .backgroundColor = { 40, 40, 40, 255 } }) {
+                if (i % 4 == 0) {
+                    CLAY_TEXT(CLAY_STRING("Row text"), CLAY_TEXT_CONFIG({ .fontSize = 10 }));
+                }
+            }
+        }
+        CLAY(CLAY_ID("LastRow"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(10) } } }) {}
+    }
+    Clay_EndLayout();
+    return Clay_GetCurrentContext()->layoutElements.length;
+}
+
+int main(void) {
+    ArenaMemory memory = { 0 };
+    Clay_ArenaMemoryFunctions memoryFunctions = { ReserveMemory, CommitMemory, ReleaseMemory, &memory };
+    Clay_Context *context = Clay_InitializeGrowable(memoryFunctions, 100000, (Clay_Dimensions) { 300, 600 }, (Clay_ErrorHandler) { Test_HandleClayErrors, NULL });
+    TEST_CHECK(context != NULL && Clay_GetCurrentContext() == context);
+    if (!context) {
+        return Test_Finish("growable_arena");
+    }
+    Clay_SetMeasureTextFunction(Test_MeasureText, NULL);
+    TEST_CHECK(Clay_GetMaxElementCount() == 100000);
+
+    RunFrame(10);
+    Clay_MemoryStats initialStats = Clay_GetMemoryStats();
+    TEST_CHECK(initialStats.arenaBytesCommitted < initialStats.arenaBytesReserved);
+
+    // Far more elements than the default max element count of 8192, which the committed memory has to grow to fit
+    int32_t rowCount = 20000;
+    int32_t elementCount = 3 + rowCount + rowCount / 4; // Including clay's own root element, Root and LastRow
+    TEST_CHECK(RunFrame(rowCount) == elementCount);
+    Clay_MemoryStats stats = Clay_GetMemoryStats();
+    TEST_CHECK(stats.arenaGrowCount > 0);
+    TEST_CHECK(stats.arenaBytesCommitted > initialStats.arenaBytesCommitted);
+    TEST_CHECK(stats.capacityExceededCount == 0);
+    Clay_ElementData lastRow = Clay_GetElementData(CLAY_ID("LastRow"));
+    TEST_CHECK(lastRow.found && lastRow.boundingBox.y == (float)rowCount * 10);
+
+    // Once grown, the same layout fits without growing again
+    Clay_ResetMemoryStats();
+    TEST_CHECK(RunFrame(rowCount) == elementCount);
+    TEST_CHECK(Clay_GetMemoryStats().arenaGrowCount == 0);
+    TEST_CHECK(Test_errorCount == 0);
+
+    Clay_ReleaseGrowable(context);
+    TEST_CHECK(Clay_GetCurrentContext() == NULL);
+    TEST_CHECK(memory.reservedBytes > 0 && memory.releasedBytes == memory.reservedBytes);
+    return Test_Finish("growable_arena");
+}
@@ -0,0 +1,80 @@
+// Checks that a cached layout returns the same render commands as calculating it again, and that anything that could make the
+// previous frame's render commands stale prevents a cache hit.
+#define CLAY_PROFILE
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include "test.h"
+
+// A layout using text wrapping, growing, floating and borders, with the color of one row as the only input
+void DeclareLayout(Clay_Color highlight) {
+    CLAY(CLAY_ID("Root"), { .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .padding = CLAY_PADDING_ALL(8), .childGap = 4 } }) {
+        for (int32_t i = 0; i < 10; ++i) {
+            CLAY(CLAY_IDI("Row", i), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .padding = CLAY_PADDING_ALL(2) }, .backgroundColor = i == 3 ? highlight : (Clay_Color) { 40, 40, 40, 255 }, .border = { .color = { 255, 0, 0, 255 }, .width = CLAY_BORDER_OUTSIDE(1) } }) {
+                CLAY_TEXT(CLAY_STRING("Some text that wraps onto several lines"), CLAY_TEXT_CONFIG({ .fontSize = 12 }));
+            }
+        }
+        CLAY(CLAY_ID("Tooltip"), { .floating = { .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID, .parentId = CLAY_IDI("Row", 3).id, .attachPoints = { .parent = CLAY_ATTACH_POINT_RIGHT_BOTTOM } }, .layout = { .sizing = { CLAY_SIZING_FIXED(50), CLAY_SIZING_FIXED(20) } }, .backgroundColor = { 0, 0, 255, 255 } }) {}
+    }
+}
+
+Clay_RenderCommandArray RunFrame(Clay_Color highlight) {
+    Clay_BeginLayout();
+    DeclareLayout(highlight);
+    return Clay_EndLayout();
+}
+
+// The sizing phases are skipped entirely on a cache hit
+bool LastFrameWasCacheHit(void) {
+    return Clay_GetProfileFrame().phases[CLAY_PROFILE_PHASE_SIZE_X].startTicks == 0;
+}
+
+int main(void) {
+    Clay_Color gray = { 40, 40, 40, 255 };
+    Clay_Color yellow = { 255, 255, 0, 255 };
+    Clay_Arena referenceArena = Test_CreateContext((Clay_Dimensions) { 300, 600 });
+    Clay_Context *reference = Clay_GetCurrentContext();
+    Clay_Arena cachedArena = Test_CreateContext((Clay_Dimensions) { 300, 600 });
+    Clay_Context *cached = Clay_GetCurrentContext();
+    Clay_SetLayoutCachingEnabled(true);
+
+    // A layout has to be calculated twice from the same input before it's reused
+    RunFrame(gray);
+    TEST_CHECK(!LastFrameWasCacheHit());
+    RunFrame(gray);
+    TEST_CHECK(!LastFrameWasCacheHit());
+    Clay_RenderCommandArray hit = RunFrame(gray);
+    TEST_CHECK(LastFrameWasCacheHit());
+
+    Clay_SetCurrentContext(reference);
+    RunFrame(gray);
+    Clay_RenderCommandArray fresh = RunFrame(gray);
+    TEST_CHECK(fresh.length > 20);
+    TEST_CHECK(Test_RenderCommandArraysEqual(hit, fresh));
+
+    // A changed declaration is calculated again, and the next identical frame is only reused once it has been calculated twice
+    Clay_SetCurrentContext(cached);
+    Clay_RenderCommandArray changed = RunFrame(yellow);
+    TEST_CHECK(!LastFrameWasCacheHit());
+    Clay_SetCurrentContext(reference);
+    fresh = RunFrame(yellow);
+    TEST_CHECK(Test_RenderCommandArraysEqual(changed, fresh));
+    Clay_SetCurrentContext(cached);
+    RunFrame(yellow);
+    RunFrame(yellow);
+    TEST_CHECK(LastFrameWasCacheHit());
+
+    // Changing capacities moves the ephemeral memory that holds the render commands, so the next frame can't reuse them
+    Clay_SetArrayCapacities((Clay_ArrayCapacities) { .elementConfigBytes = 4096, .textElements = 64 });
+    Clay_RenderCommandArray moved = RunFrame(yellow);
+    TEST_CHECK(!LastFrameWasCacheHit());
+    TEST_CHECK(Test_RenderCommandArraysEqual(moved, fresh));
+    Clay_SetMaxElementCount(Clay_GetMaxElementCount() / 2);
+    moved = RunFrame(yellow);
+    TEST_CHECK(!LastFrameWasCacheHit());
+    TEST_CHECK(Test_RenderCommandArraysEqual(moved, fresh));
+
+    TEST_CHECK(Test_errorCount == 0);
+    free(cachedArena.memory);
+    free(referenceArena.memory);
+    return Test_Finish("layout_cache");
+}
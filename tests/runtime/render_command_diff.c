@@ -0,0 +1,84 @@
+// Checks that changing, adding and removing one element shows up as a single command in the render command diff, and that
+// diffing can't be enabled without its memory.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include "test.h"
+
+// A fixed size column of rows, so that changing one row or adding one at the end doesn't move anything else
+Clay_RenderCommandArray RunFrame(int32_t rowCount, Clay_Color highlight) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Root"), { .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = { CLAY_SIZING_FIXED(200), CLAY_SIZING_FIXED(400) }, .childGap = 4 }, .backgroundColor = { 20, 20, 20, 255 } }) {
+        for (int32_t i = 0; i < rowCount; ++i) {
+            CLAY(CLAY_IDI("Row", i), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(20) } }, .backgroundColor = i == 2 ? highlight : (Clay_Color) { 40, 40, 40, 255 } }) {}
+        }
+    }
+    return Clay_EndLayout();
+}
+
+bool DiffIsEmpty(Clay_RenderCommandDiff diff) {
+    return diff.inserted.length == 0 && diff.removed.length == 0 && diff.modified.length == 0 && diff.previousModified.length == 0;
+}
+
+int main(void) {
+    Clay_Color gray = { 40, 40, 40, 255 };
+    Clay_Color yellow = { 255, 255, 0, 255 };
+
+    // Without a .diffedRenderCommands, enabling diffing reports one error and leaves it disabled, rather than failing every frame
+    Clay_Arena withoutMemoryArena = Test_CreateContext((Clay_Dimensions) { 300, 600 });
+    Clay_SetRenderCommandDiffingEnabled(true);
+    TEST_CHECK(Test_errorCount == 1);
+    RunFrame(5, gray);
+    RunFrame(5, yellow);
+    TEST_CHECK(Test_errorCount == 1);
+    TEST_CHECK(DiffIsEmpty(Clay_GetRenderCommandDiff()));
+    free(withoutMemoryArena.memory);
+    Clay_SetCurrentContext(NULL);
+    Test_errorCount = 0;
+
+    Clay_SetArrayCapacities((Clay_ArrayCapacities) { .diffedRenderCommands = 64 });
+    Clay_Arena arena = Test_CreateContext((Clay_Dimensions) { 300, 600 });
+    Clay_SetRenderCommandDiffingEnabled(true);
+
+    // The first frame can't be compared with anything, so every command is inserted
+    Clay_RenderCommandArray commands = RunFrame(5, gray);
+    Clay_RenderCommandDiff diff = Clay_GetRenderCommandDiff();
+    TEST_CHECK(!diff.unchanged);
+    TEST_CHECK(diff.inserted.length == commands.length);
+
+    RunFrame(5, gray);
+    diff = Clay_GetRenderCommandDiff();
+    TEST_CHECK(diff.unchanged);
+    TEST_CHECK(DiffIsEmpty(diff));
+
+    // Changing the color of one row modifies only its rectangle, and keeps a copy of the previous version
+    RunFrame(5, yellow);
+    diff = Clay_GetRenderCommandDiff();
+    TEST_CHECK(!diff.unchanged);
+    TEST_CHECK(diff.inserted.length == 0 && diff.removed.length == 0);
+    TEST_CHECK(diff.modified.length == 1 && diff.previousModified.length == 1);
+    if (diff.modified.length == 1 && diff.previousModified.length == 1) {
+        TEST_CHECK(diff.modified.internalArray[0].id == CLAY_IDI("Row", 2).id);
+        TEST_CHECK(diff.modified.internalArray[0].renderData.rectangle.backgroundColor.r == 255);
+        TEST_CHECK(diff.previousModified.internalArray[0].id == CLAY_IDI("Row", 2).id);
+        TEST_CHECK(diff.previousModified.internalArray[0].renderData.rectangle.backgroundColor.r == 40);
+    }
+
+    // A row added at the end is inserted, and removed again on the next frame
+    RunFrame(6, yellow);
+    diff = Clay_GetRenderCommandDiff();
+    TEST_CHECK(diff.inserted.length == 1 && diff.removed.length == 0 && diff.modified.length == 0);
+    if (diff.inserted.length == 1) {
+        TEST_CHECK(diff.inserted.internalArray[0].id == CLAY_IDI("Row", 5).id);
+        TEST_CHECK(Test_BoundingBoxesEqual(diff.inserted.internalArray[0].boundingBox, (Clay_BoundingBox) { 0, 120, 200, 20 }));
+    }
+    RunFrame(5, yellow);
+    diff = Clay_GetRenderCommandDiff();
+    TEST_CHECK(diff.inserted.length == 0 && diff.removed.length == 1 && diff.modified.length == 0);
+    if (diff.removed.length == 1) {
+        TEST_CHECK(diff.removed.internalArray[0].id == CLAY_IDI("Row", 5).id);
+    }
+
+    TEST_CHECK(Test_errorCount == 0);
+    free(arena.memory);
+    return Test_Finish("render_command_diff");
+}
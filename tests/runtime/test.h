@@ -0,0 +1,72 @@
+// Helpers shared by the runtime tests. Each test is a separate program that includes the clay implementation before this header,
+// and exits with a non-zero status if any check failed.
+#include <stdio.h>
+#include <stdlib.h>
+
+int Test_failureCount = 0;
+int Test_errorCount = 0;
+
+#define TEST_CHECK(condition) do { if (!(condition)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); Test_failureCount++; } } while (0)
+
+void Test_HandleClayErrors(Clay_ErrorData errorData) {
+    printf("clay error: %.*s\n", errorData.errorText.length, errorData.errorText.chars);
+    Test_errorCount++;
+}
+
+// Every character is 10 units wide and fontSize units tall, so that expected sizes can be calculated by hand
+Clay_Dimensions Test_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    (void)userData;
+    return (Clay_Dimensions) { (float)text.length * 10, (float)config->fontSize };
+}
+
+// Creates and activates a context in a newly allocated fixed arena, which the caller frees with free(arena.memory)
+Clay_Arena Test_CreateContext(Clay_Dimensions dimensions) {
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, dimensions, (Clay_ErrorHandler) { Test_HandleClayErrors, NULL });
+    Clay_SetMeasureTextFunction(Test_MeasureText, NULL);
+    return arena;
+}
+
+bool Test_BoundingBoxesEqual(Clay_BoundingBox a, Clay_BoundingBox b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+// Compares the fields of two render commands that a renderer would use, ignoring padding
+bool Test_RenderCommandsEqual(Clay_RenderCommand *a, Clay_RenderCommand *b) {
+    if (a->id != b->id || a->commandType != b->commandType || a->zIndex != b->zIndex || !Test_BoundingBoxesEqual(a->boundingBox, b->boundingBox)) {
+        return false;
+    }
+    switch (a->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            Clay_Color ca = a->renderData.rectangle.backgroundColor, cb = b->renderData.rectangle.backgroundColor;
+            return ca.r == cb.r && ca.g == cb.g && ca.b == cb.b && ca.a == cb.a;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            Clay_StringSlice sa = a->renderData.text.stringContents, sb = b->renderData.text.stringContents;
+            return sa.length == sb.length && sa.chars == sb.chars && a->renderData.text.fontSize == b->renderData.text.fontSize;
+        }
+        default: return true;
+    }
+}
+
+bool Test_RenderCommandArraysEqual(Clay_RenderCommandArray a, Clay_RenderCommandArray b) {
+    if (a.length != b.length) {
+        return false;
+    }
+    for (int32_t i = 0; i < a.length; ++i) {
+        if (!Test_RenderCommandsEqual(&a.internalArray[i], &b.internalArray[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int Test_Finish(const char *name) {
+    if (Test_failureCount > 0) {
+        fprintf(stderr, "%s: %d check(s) failed\n", name, Test_failureCount);
+        return 1;
+    }
+    printf("%s: passed\n", name);
+    return 0;
+}
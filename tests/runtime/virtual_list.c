@@ -0,0 +1,87 @@
+// Checks that a virtual list declares only the items in view, and that the spacers in place of the other items put the visible
+// items and the scrollable size where they would be if every item was declared.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#include "test.h"
+
+#define ITEM_COUNT 1000
+#define ITEM_EXTENT 20
+#define CHILD_GAP 4
+#define STRIDE (ITEM_EXTENT + CHILD_GAP)
+#define LIST_HEIGHT 100
+
+typedef struct {
+    int32_t firstDeclared;
+    int32_t lastDeclared;
+} DeclaredRange;
+
+void DeclareItem(int32_t index, void *userData) {
+    DeclaredRange *range = (DeclaredRange *)userData;
+    range->firstDeclared = CLAY__MIN(range->firstDeclared, index);
+    range->lastDeclared = CLAY__MAX(range->lastDeclared, index);
+    CLAY(CLAY_IDI("Item", index), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(ITEM_EXTENT) } }, .backgroundColor = { 40, 40, 40, 255 } }) {}
+}
+
+DeclaredRange RunFrame(float scrollY) {
+    DeclaredRange range = { ITEM_COUNT, -1 };
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("List"), {
+        .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = { CLAY_SIZING_FIXED(200), CLAY_SIZING_FIXED(LIST_HEIGHT) }, .childGap = CHILD_GAP },
+        .clip = { .vertical = true, .childOffset = { 0, -scrollY } },
+        .virtualList = { .itemCount = ITEM_COUNT, .itemExtent = ITEM_EXTENT, .overscan = 1, .declareItem = DeclareItem, .userData = &range }
+    }) {}
+    Clay_EndLayout();
+    return range;
+}
+
+// The heights of the list's first and last children, which are the spacers when items before or after the visible ones are skipped
+void GetOuterChildHeights(int32_t *childCount, float *firstHeight, float *lastHeight) {
+    Clay_LayoutElement *list = Clay__GetHashMapItem(CLAY_ID("List").id)->layoutElement;
+    Clay_Context *context = Clay_GetCurrentContext();
+    *childCount = list->childrenOrTextContent.children.length;
+    *firstHeight = Clay_LayoutElementArray_Get(&context->layoutElements, list->childrenOrTextContent.children.elements[0])->dimensions.height;
+    *lastHeight = Clay_LayoutElementArray_Get(&context->layoutElements, list->childrenOrTextContent.children.elements[*childCount - 1])->dimensions.height;
+}
+
+int main(void) {
+    Clay_Arena arena = Test_CreateContext((Clay_Dimensions) { 300, 600 });
+    int32_t childCount;
+    float firstHeight, lastHeight;
+
+    // Scrolled by 10 items, the visible items are 10 to 14, plus one more on each side
+    RunFrame(10 * STRIDE);
+    DeclaredRange range = RunFrame(10 * STRIDE);
+    TEST_CHECK(range.firstDeclared == 9 && range.lastDeclared == 15);
+    GetOuterChildHeights(&childCount, &firstHeight, &lastHeight);
+    TEST_CHECK(childCount == 2 + 7);
+    TEST_CHECK(firstHeight == 9 * STRIDE - CHILD_GAP);
+    TEST_CHECK(lastHeight == (ITEM_COUNT - 1 - 15) * STRIDE - CHILD_GAP);
+    for (int32_t i = range.firstDeclared; i <= range.lastDeclared; ++i) {
+        Clay_ElementData item = Clay_GetElementData(CLAY_IDI("Item", i));
+        TEST_CHECK(item.found && item.boundingBox.y == (float)(i * STRIDE - 10 * STRIDE));
+    }
+    Clay_ScrollContainerData scrollData = Clay_GetScrollContainerData(CLAY_ID("List"));
+    TEST_CHECK(scrollData.found && scrollData.contentDimensions.height == ITEM_COUNT * STRIDE - CHILD_GAP);
+
+    // At the start of the list there is no spacer before the items, and at the end there is none after them
+    range = RunFrame(0);
+    TEST_CHECK(range.firstDeclared == 0 && range.lastDeclared == 5);
+    GetOuterChildHeights(&childCount, &firstHeight, &lastHeight);
+    TEST_CHECK(childCount == 6 + 1);
+    TEST_CHECK(firstHeight == ITEM_EXTENT);
+    TEST_CHECK(lastHeight == (ITEM_COUNT - 1 - 5) * STRIDE - CHILD_GAP);
+
+    float endScrollY = ITEM_COUNT * STRIDE - CHILD_GAP - LIST_HEIGHT;
+    range = RunFrame(endScrollY);
+    TEST_CHECK(range.firstDeclared == 994 && range.lastDeclared == ITEM_COUNT - 1);
+    GetOuterChildHeights(&childCount, &firstHeight, &lastHeight);
+    TEST_CHECK(childCount == 1 + 6);
+    TEST_CHECK(firstHeight == 994 * STRIDE - CHILD_GAP);
+    TEST_CHECK(lastHeight == ITEM_EXTENT);
+    scrollData = Clay_GetScrollContainerData(CLAY_ID("List"));
+    TEST_CHECK(scrollData.found && scrollData.contentDimensions.height == ITEM_COUNT * STRIDE - CHILD_GAP);
+
+    TEST_CHECK(Test_errorCount == 0);
+    free(arena.memory);
+    return Test_Finish("virtual_list");
+}